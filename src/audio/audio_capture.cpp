@@ -1,6 +1,9 @@
 #include "audio/audio_capture.hpp"
+#include "audio/sample_convert.hpp"
 #include <QtCore/QDebug>
 #include <RtAudio.h>
+#include <chrono>
+#include <algorithm>
 
 namespace whisper_client {
 namespace audio {
@@ -9,6 +12,22 @@ AudioCapture::AudioCapture()
     : audio(std::make_unique<RtAudio>())
     , currentDeviceId(0)
     , recording(false)
+    , warmStream(false)
+    , preRollMs(0)
+    , deviceRate(sampleRate)
+    , deviceChannels(channels)
+    , ringBuffer(std::make_unique<SpscRingBuffer<float>>(maxDeviceRate * maxDeviceChannels * ringSeconds))
+    , compactCapture(false)
+    , compactStream(false)
+    , drainScratch(ringBuffer->capacity())
+    , arena(sampleRate)  // One-second pages
+    , capturing(false)
+    , continuous(false)
+    , historyWrite(0)
+    , historyFilled(0)
+    , draining(false)
+    , overflowCount(0)
+    , droppedSamples(0)
 {
     try {
         // Try to find a default input device
@@ -29,6 +48,12 @@ AudioCapture::~AudioCapture() {
     if (recording) {
         stopRecording();
     }
+    try {
+        closeInputStream();
+    }
+    catch (const RtAudioError& e) {
+        qWarning() << "Error closing input stream:" << e.getMessage().c_str();
+    }
 }
 
 std::vector<AudioDevice> AudioCapture::listInputDevices() {
@@ -56,27 +81,68 @@ std::vector<AudioDevice> AudioCapture::listInputDevices() {
 }
 
 bool AudioCapture::setDevice(unsigned int deviceId) {
+    // Verify device exists and has input channels before touching the
+    // current stream, so a bad choice leaves capture running
+    RtAudio::DeviceInfo info;
     try {
-        // Stop any active recording
-        if (recording) {
-            stopRecording();
+        info = audio->getDeviceInfo(deviceId);
+    }
+    catch (const RtAudioError& e) {
+        qWarning() << "Error querying audio device:" << e.getMessage().c_str();
+        return false;
+    }
+    if (info.inputChannels == 0) {
+        qWarning() << "Selected device has no input channels";
+        return false;
+    }
+
+    // Stop any active recording
+    if (recording) {
+        stopRecording();
+    }
+
+    // The warm stream is bound to the old device
+    const bool reopen = (warmStream || continuous) && audio->isStreamOpen();
+    const unsigned int previousDeviceId = currentDeviceId;
+    if (reopen) {
+        try {
+            closeInputStream();
         }
-        
-        // Verify device exists and has input channels
-        RtAudio::DeviceInfo info = audio->getDeviceInfo(deviceId);
-        if (info.inputChannels == 0) {
-            qWarning() << "Selected device has no input channels";
+        catch (const RtAudioError& e) {
+            qWarning() << "Error closing input stream:" << e.getMessage().c_str();
+            stopDrainThread();
             return false;
         }
-        
-        currentDeviceId = deviceId;
-        qDebug() << "Audio device set to:" << QString::fromStdString(info.name);
+    }
+
+    currentDeviceId = deviceId;
+    qDebug() << "Audio device set to:" << QString::fromStdString(info.name);
+    if (!reopen) {
+        return true;
+    }
+
+    try {
+        clearBuffer();
+        openInputStream();
         return true;
     }
     catch (const RtAudioError& e) {
-        qWarning() << "Error setting audio device:" << e.getMessage().c_str();
-        return false;
+        qWarning() << "Error opening audio device:" << e.getMessage().c_str();
     }
+
+    // Warm and continuous capture must not die with the new device; go back
+    // to the one that was working
+    currentDeviceId = previousDeviceId;
+    try {
+        closeInputStream();
+        openInputStream();
+        qDebug() << "Reopened previous audio device";
+    }
+    catch (const RtAudioError& e) {
+        qWarning() << "Error reopening previous audio device:" << e.getMessage().c_str();
+        stopDrainThread();
+    }
+    return false;
 }
 
 unsigned int AudioCapture::getCurrentDevice() const {
@@ -87,30 +153,24 @@ bool AudioCapture::startRecording() {
     if (recording) {
         return true;
     }
+    if (continuous) {
+        qWarning() << "Manual recording is unavailable in continuous mode";
+        return false;
+    }
 
     try {
-        // Clear any existing audio data
-        clearBuffer();
-        
-        // Set up the stream parameters
-        RtAudio::StreamParameters params;
-        params.deviceId = currentDeviceId;
-        params.nChannels = channels;
-        params.firstChannel = 0;
-        
-        // Open the stream
-        audio->openStream(
-            nullptr,      // No output
-            &params,      // Input parameters
-            RTAUDIO_FLOAT32,  // Using float samples
-            sampleRate,
-            &bufferFrames,
-            &AudioCapture::recordCallback,
-            this
-        );
-        
-        // Start the stream
-        audio->startStream();
+        if (warmStream && audio->isStreamOpen()) {
+            // Stream is already running; pre-roll comes from the history
+            beginUtterance();
+        } else {
+            // Clear any existing audio data
+            clearBuffer();
+            beginUtterance();
+            if (!openInputStream()) {
+                endUtterance();
+                return false;
+            }
+        }
         recording = true;
         
         if (onRecordingStart) {
@@ -122,48 +182,349 @@ bool AudioCapture::startRecording() {
     }
     catch (const RtAudioError& e) {
         qWarning() << "Error starting recording:" << e.getMessage().c_str();
+        stopDrainThread();
+        endUtterance();
         recording = false;
         return false;
     }
 }
 
-std::vector<float> AudioCapture::stopRecording() {
+UtteranceBuffer AudioCapture::stopRecording() {
     if (!recording) {
-        return std::vector<float>();
+        return UtteranceBuffer();
     }
 
     try {
-        // Stop the stream
-        audio->stopStream();
-        if (audio->isStreamOpen()) {
-            audio->closeStream();
+        if (warmStream) {
+            // Pull in everything captured up to the release, keep the stream running
+            drainRingBuffer();
+        } else {
+            // The callback has stopped, so whatever is left in the ring is final
+            closeInputStream();
         }
         
         recording = false;
-        
-        // Combine all audio data
-        std::vector<float> combinedAudio;
-        {
-            std::lock_guard<std::mutex> lock(audioMutex);
-            while (!audioQueue.empty()) {
-                auto& chunk = audioQueue.front();
-                combinedAudio.insert(combinedAudio.end(), chunk.begin(), chunk.end());
-                audioQueue.pop();
-            }
+        UtteranceBuffer utterance = endUtterance();
+
+        if (overflowCount > 0 || droppedSamples > 0) {
+            qWarning() << "Stream overflow detected!" << overflowCount.load()
+                       << "overflows," << droppedSamples.load() << "samples dropped";
         }
         
         if (onRecordingStop) {
             onRecordingStop();
         }
         
-        qDebug() << "Recording stopped, collected" << combinedAudio.size() << "samples";
-        return combinedAudio;
+        qDebug() << "Recording stopped, collected" << utterance.size() << "samples";
+        return utterance;
     }
     catch (const RtAudioError& e) {
         qWarning() << "Error stopping recording:" << e.getMessage().c_str();
+        stopDrainThread();
         recording = false;
-        return std::vector<float>();
+        return endUtterance();
+    }
+}
+
+bool AudioCapture::openInputStream() {
+    // Capture in the device's own format rather than relying on the backend
+    // to convert; many interfaces only run at 44.1/48 kHz stereo
+    RtAudio::DeviceInfo info = audio->getDeviceInfo(currentDeviceId);
+    deviceRate = info.preferredSampleRate > 0 ? info.preferredSampleRate : sampleRate;
+    deviceChannels = std::clamp(info.inputChannels, 1u, maxDeviceChannels);
+    {
+        // The drain thread is stopped here, but stopDrainThread drains once more
+        std::lock_guard<std::mutex> drainLock(drainMutex);
+        if (!resampler.configure(deviceRate, deviceChannels, sampleRate)) {
+            qWarning() << "Unsupported device rate" << deviceRate << "- asking the backend for" << sampleRate;
+            deviceRate = sampleRate;
+            resampler.configure(deviceRate, deviceChannels, sampleRate);
+        }
+
+        // Swap the ring for the requested sample format
+        {
+            std::lock_guard<std::mutex> lock(audioMutex);
+            compactStream = compactCapture;
+        }
+        const size_t ringSamples = drainScratch.size();
+        if (compactStream && !compactRingBuffer) {
+            compactRingBuffer = std::make_unique<SpscRingBuffer<int16_t>>(ringSamples);
+            compactScratch.resize(ringSamples);
+            ringBuffer.reset();
+        } else if (!compactStream && !ringBuffer) {
+            ringBuffer = std::make_unique<SpscRingBuffer<float>>(ringSamples);
+            compactRingBuffer.reset();
+            compactScratch = std::vector<int16_t>();
+        }
+    }
+    qDebug() << "Opening input at" << deviceRate << "Hz," << deviceChannels << "channel(s),"
+             << (compactStream ? "16-bit" : "float") << "samples";
+
+    startDrainThread();
+
+    // Set up the stream parameters
+    RtAudio::StreamParameters params;
+    params.deviceId = currentDeviceId;
+    params.nChannels = deviceChannels;
+    params.firstChannel = 0;
+    
+    // Open the stream
+    unsigned int frames = bufferFrames * deviceRate / sampleRate;
+    audio->openStream(
+        nullptr,      // No output
+        &params,      // Input parameters
+        compactStream ? RTAUDIO_SINT16 : RTAUDIO_FLOAT32,
+        deviceRate,
+        &frames,
+        &AudioCapture::recordCallback,
+        this
+    );
+    
+    // Start the stream
+    audio->startStream();
+    return true;
+}
+
+void AudioCapture::closeInputStream() {
+    if (audio->isStreamOpen()) {
+        if (audio->isStreamRunning()) {
+            audio->stopStream();
+        }
+        audio->closeStream();
+    }
+    stopDrainThread();
+}
+
+bool AudioCapture::setWarmStreamEnabled(bool enabled) {
+    if (warmStream == enabled) {
+        return true;
+    }
+    warmStream = enabled;
+
+    // An active recording keeps its stream; the new mode applies from the next
+    // one. Continuous mode keeps the stream open regardless.
+    if (recording || continuous) {
+        return true;
+    }
+
+    try {
+        if (enabled) {
+            clearBuffer();
+            openInputStream();
+            qDebug() << "Warm input stream opened";
+        } else {
+            closeInputStream();
+            qDebug() << "Warm input stream closed";
+        }
+        return true;
+    }
+    catch (const RtAudioError& e) {
+        qWarning() << "Error switching warm stream:" << e.getMessage().c_str();
+        stopDrainThread();
+        warmStream = false;
+        return false;
+    }
+}
+
+bool AudioCapture::isWarmStreamEnabled() const {
+    return warmStream;
+}
+
+void AudioCapture::setPreRollMs(unsigned int ms) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    preRollMs = ms;
+    const unsigned int historyMs = continuous ? std::max(ms, continuousPreRollMs) : ms;
+    history.assign(static_cast<size_t>(sampleRate) * channels * historyMs / 1000, 0.0f);
+    historyWrite = 0;
+    historyFilled = 0;
+}
+
+unsigned int AudioCapture::getPreRollMs() const {
+    return preRollMs;
+}
+
+void AudioCapture::beginUtterance() {
+    UtteranceBuffer utterance = arena.acquire(compactCapture);
+    overflowCount = 0;
+    droppedSamples = 0;
+
+    std::lock_guard<std::mutex> lock(audioMutex);
+    beginUtteranceLocked(std::move(utterance));
+}
+
+void AudioCapture::beginUtteranceLocked(UtteranceBuffer utterance) {
+    currentUtterance = std::move(utterance);
+    capturing = true;
+    if (melFrontend) {
+        melFrontend->reset();
+    }
+    if (voiceActivity) {
+        voiceActivity->reset();
+    }
+
+    // Oldest history first: [historyWrite, end) then [0, historyWrite)
+    if (historyFilled > 0) {
+        const size_t start = (historyWrite + history.size() - historyFilled) % history.size();
+        const size_t first = std::min(historyFilled, history.size() - start);
+        captureSamples(history.data() + start, first);
+        captureSamples(history.data(), historyFilled - first);
+        historyFilled = 0;
+    }
+}
+
+void AudioCapture::captureSamples(const float* data, size_t count) {
+    currentUtterance.append(data, count);
+    if (melFrontend) {
+        melFrontend->addSamples(data, count);
+    }
+    if (voiceActivity) {
+        voiceActivity->addSamples(data, count);
+    }
+}
+
+UtteranceBuffer AudioCapture::endUtterance() {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    return endUtteranceLocked();
+}
+
+UtteranceBuffer AudioCapture::endUtteranceLocked() {
+    capturing = false;
+    // A frontend switched on mid-recording has only seen part of the audio
+    if (melFrontend && !currentUtterance.empty() &&
+        melFrontend->sampleCount() == currentUtterance.size()) {
+        currentUtterance.setMel(melFrontend->finish());
+    }
+    if (voiceActivity && !currentUtterance.empty() &&
+        voiceActivity->sampleCount() == currentUtterance.size()) {
+        const VoiceActivityDetector::SpeechRange range = voiceActivity->analyse();
+        currentUtterance.setSpeechRange(range.begin, range.speech ? range.end : range.begin);
+        qDebug() << "Speech range:" << range.begin << "-" << range.end << "of" << currentUtterance.size() << "samples";
+    }
+    return std::move(currentUtterance);
+}
+
+UtteranceBuffer AudioCapture::snapshotRecording(size_t fromSample) {
+    UtteranceBuffer window = arena.acquire();
+
+    std::lock_guard<std::mutex> lock(audioMutex);
+    if (capturing && fromSample < currentUtterance.size()) {
+        window.append(currentUtterance, fromSample);
+    }
+    return window;
+}
+
+void AudioCapture::setMelPrecompute(int nMel) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    if (nMel <= 0) {
+        melFrontend.reset();
+    } else if (!melFrontend) {
+        melFrontend = std::make_unique<MelFrontend>(nMel);
+    } else {
+        melFrontend->setMelCount(nMel);
+    }
+}
+
+void AudioCapture::setVoiceActivityDetection(bool enabled) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    if (!enabled) {
+        voiceActivity.reset();
+    } else if (!voiceActivity) {
+        // Takes effect from the next recording; see endUtterance
+        voiceActivity = std::make_unique<VoiceActivityDetector>();
+    }
+}
+
+bool AudioCapture::setContinuousMode(bool enabled) {
+    if (enabled && recording) {
+        stopRecording();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(audioMutex);
+        if (continuous == enabled) {
+            return true;
+        }
+        continuous = enabled;
+        endpointer.reset();
+        if (capturing) {
+            endUtteranceLocked();  // A half-finished utterance is dropped
+        }
+
+        // Endpointing needs history for the audio before the onset is confirmed
+        const size_t minHistory = static_cast<size_t>(sampleRate) * channels * continuousPreRollMs / 1000;
+        if (enabled && history.size() < minHistory) {
+            history.assign(minHistory, 0.0f);
+            historyWrite = 0;
+            historyFilled = 0;
+        }
+    }
+
+    // The endpointer runs on the warm stream's drain thread
+    if (warmStream) {
+        return true;
+    }
+    try {
+        if (enabled) {
+            clearBuffer();
+            openInputStream();
+        } else {
+            closeInputStream();
+        }
+        qDebug() << "Continuous capture" << (enabled ? "started" : "stopped");
+        return true;
+    }
+    catch (const RtAudioError& e) {
+        qWarning() << "Error switching continuous capture:" << e.getMessage().c_str();
+        stopDrainThread();
+        std::lock_guard<std::mutex> lock(audioMutex);
+        continuous = false;
+        return false;
+    }
+}
+
+bool AudioCapture::isContinuousMode() const {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    return continuous;
+}
+
+void AudioCapture::setEndpointTimeoutMs(unsigned int ms) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    endpointer.setEndpointTimeoutMs(ms);
+}
+
+void AudioCapture::setCompactCapture(bool enabled) {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    compactCapture = enabled;
+    if (enabled) {
+        qDebug() << "16-bit capture, conversion kernels:" << sampleConversionKernel();
+    }
+}
+
+bool AudioCapture::isCompactCapture() const {
+    std::lock_guard<std::mutex> lock(audioMutex);
+    return compactCapture;
+}
+
+void AudioCapture::setUtteranceCallback(std::function<void(UtteranceBuffer)> callback) {
+    onUtterance = std::move(callback);
+}
+
+void AudioCapture::writeHistory(const float* data, size_t count) {
+    if (history.empty()) {
+        return;
     }
+
+    // Only the newest history.size() samples matter
+    if (count > history.size()) {
+        data += count - history.size();
+        count = history.size();
+    }
+
+    const size_t first = std::min(count, history.size() - historyWrite);
+    std::copy(data, data + first, history.begin() + historyWrite);
+    std::copy(data + first, data + count, history.begin());
+    historyWrite = (historyWrite + count) % history.size();
+    historyFilled = std::min(historyFilled + count, history.size());
 }
 
 bool AudioCapture::isRecording() const {
@@ -184,29 +545,136 @@ int AudioCapture::recordCallback(void* outputBuffer, void* inputBuffer,
     (void)outputBuffer;  // Unused
     (void)streamTime;    // Unused
     
+    auto* capture = static_cast<AudioCapture*>(userData);
+
+    // Never log from the audio thread; overflows are reported on stop
     if (status) {
-        qWarning() << "Stream overflow detected!";
+        capture->overflowCount.fetch_add(1, std::memory_order_relaxed);
     }
     
-    auto* capture = static_cast<AudioCapture*>(userData);
-    const float* input = static_cast<const float*>(inputBuffer);
-    
-    capture->processAudioData(input, nFrames);
+    if (capture->compactStream) {
+        capture->processAudioData(*capture->compactRingBuffer, static_cast<const int16_t*>(inputBuffer), nFrames);
+    } else {
+        capture->processAudioData(*capture->ringBuffer, static_cast<const float*>(inputBuffer), nFrames);
+    }
     
     return 0;
 }
 
-void AudioCapture::processAudioData(const float* buffer, unsigned int frames) {
-    std::vector<float> chunk(buffer, buffer + frames * channels);
-    
-    std::lock_guard<std::mutex> lock(audioMutex);
-    audioQueue.push(std::move(chunk));
+template <typename T>
+void AudioCapture::processAudioData(SpscRingBuffer<T>& ring, const T* buffer, unsigned int frames) {
+    // Real-time thread: bounded memcpy and an atomic index update, nothing else.
+    // Only whole frames go in, so the drain thread never sees channels shift.
+    const size_t count = static_cast<size_t>(frames) * deviceChannels;
+    const size_t space = ring.capacity() - ring.available();
+    const size_t written = ring.write(buffer, std::min(count, space - space % deviceChannels));
+    if (written < count) {
+        droppedSamples.fetch_add(count - written, std::memory_order_relaxed);
+    }
 }
 
 void AudioCapture::clearBuffer() {
+    if (compactRingBuffer) {
+        compactRingBuffer->reset();
+    } else {
+        ringBuffer->reset();
+    }
+    overflowCount = 0;
+    droppedSamples = 0;
+
     std::lock_guard<std::mutex> lock(audioMutex);
-    std::queue<std::vector<float>> empty;
-    std::swap(audioQueue, empty);
+    historyWrite = 0;
+    historyFilled = 0;
+}
+
+void AudioCapture::startDrainThread() {
+    if (draining) {
+        return;
+    }
+    draining = true;
+    drainThread = std::thread(&AudioCapture::drainLoop, this);
+}
+
+void AudioCapture::stopDrainThread() {
+    draining = false;
+    if (drainThread.joinable()) {
+        drainThread.join();
+    }
+    drainRingBuffer();
+}
+
+void AudioCapture::drainLoop() {
+    while (draining) {
+        drainRingBuffer();
+        std::this_thread::sleep_for(std::chrono::milliseconds(drainIntervalMs));
+    }
+}
+
+void AudioCapture::drainRingBuffer() {
+    std::lock_guard<std::mutex> drainLock(drainMutex);
+
+    std::vector<UtteranceBuffer> finished;
+    const size_t readSize = drainScratch.size() - drainScratch.size() % deviceChannels;
+    size_t read;
+    while ((read = readRingBuffer(readSize)) > 0) {
+        // Downmix and resample to 16 kHz mono outside audioMutex
+        converted.clear();
+        resampler.process(drainScratch.data(), read / deviceChannels, converted);
+        const float* samples = converted.data();
+        const size_t count = converted.size();
+
+        std::lock_guard<std::mutex> lock(audioMutex);
+        if (continuous) {
+            drainContinuous(samples, count, finished);
+        } else if (capturing) {
+            captureSamples(samples, count);
+        } else {
+            writeHistory(samples, count);
+        }
+    }
+
+    // Handed over outside audioMutex; the receiver may block briefly
+    for (UtteranceBuffer& utterance : finished) {
+        qDebug() << "Endpoint detected, utterance of" << utterance.size() << "samples";
+        if (onUtterance) {
+            onUtterance(std::move(utterance));
+        }
+    }
+}
+
+size_t AudioCapture::readRingBuffer(size_t count) {
+    if (!compactRingBuffer) {
+        return ringBuffer->read(drainScratch.data(), count);
+    }
+
+    // 16-bit samples become float here, before downmixing and resampling
+    const size_t read = compactRingBuffer->read(compactScratch.data(), count);
+    int16ToFloat(compactScratch.data(), drainScratch.data(), read);
+    return read;
+}
+
+void AudioCapture::drainContinuous(const float* data, size_t count, std::vector<UtteranceBuffer>& finished) {
+    size_t offset = 0;
+    while (offset < count) {
+        SpeechEndpointer::Event event;
+        const size_t used = endpointer.feed(data + offset, count - offset, &event);
+
+        if (capturing) {
+            captureSamples(data + offset, used);
+        } else {
+            writeHistory(data + offset, used);
+        }
+        offset += used;
+
+        if (event == SpeechEndpointer::Event::SpeechStart && !capturing) {
+            // The onset frames are already in the history, so they lead the utterance
+            beginUtteranceLocked(arena.acquire(compactCapture));
+        } else if (event == SpeechEndpointer::Event::SpeechEnd && capturing) {
+            finished.push_back(endUtteranceLocked());
+        } else if (event == SpeechEndpointer::Event::SpeechDiscard && capturing) {
+            endUtteranceLocked();
+        }
+    }
 }
 
 } // namespace audio
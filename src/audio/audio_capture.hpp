@@ -2,12 +2,18 @@
 
 #include <RtAudio.h>
 #include <vector>
-#include <queue>
 #include <mutex>
 #include <memory>
 #include <functional>
+#include <thread>
+#include <atomic>
 #include <QtCore/QString>
 #include <stdexcept>
+#include "audio/ring_buffer.hpp"
+#include "audio/utterance_buffer.hpp"
+#include "audio/mel_frontend.hpp"
+#include "audio/voice_activity.hpp"
+#include "audio/resampler.hpp"
 
 namespace whisper_client {
 namespace audio {
@@ -31,9 +37,43 @@ public:
 
     // Recording control
     bool startRecording();
-    std::vector<float> stopRecording();
+    UtteranceBuffer stopRecording();
     bool isRecording() const;
 
+    // Warm stream: keep the input open between recordings and start each
+    // recording from a short history of audio captured before the press
+    bool setWarmStreamEnabled(bool enabled);
+    bool isWarmStreamEnabled() const;
+    void setPreRollMs(unsigned int ms);
+    unsigned int getPreRollMs() const;
+
+    // Copy of the audio recorded so far from fromSample on, for streaming
+    // partial transcripts. Empty when not recording.
+    UtteranceBuffer snapshotRecording(size_t fromSample);
+
+    // Builds the log-mel spectrogram incrementally while recording so it is
+    // ready when the recording stops. nMel must match the loaded model; 0
+    // turns it off.
+    void setMelPrecompute(int nMel);
+
+    // Tracks speech energy while recording and marks the speech range on the
+    // finished utterance, so leading and trailing silence is not decoded
+    void setVoiceActivityDetection(bool enabled);
+
+    // Hands-free capture: keeps the input stream open and lets an endpointer
+    // on the drain thread cut speech into utterances. Each finished utterance
+    // is passed to the utterance callback on the drain thread.
+    bool setContinuousMode(bool enabled);
+    bool isContinuousMode() const;
+    void setEndpointTimeoutMs(unsigned int ms);
+    void setUtteranceCallback(std::function<void(UtteranceBuffer)> callback);
+
+    // Opens the device as 16-bit PCM and keeps recordings as 16-bit samples,
+    // halving buffer memory and copy bandwidth. The stream format changes the
+    // next time the input is opened.
+    void setCompactCapture(bool enabled);
+    bool isCompactCapture() const;
+
     // Callbacks
     void setRecordingStartCallback(std::function<void()> callback);
     void setRecordingStopCallback(std::function<void()> callback);
@@ -43,24 +83,82 @@ private:
                             unsigned int nFrames, double streamTime,
                             RtAudioStreamStatus status, void* userData);
 
-    void processAudioData(const float* buffer, unsigned int frames);
+    template <typename T>
+    void processAudioData(SpscRingBuffer<T>& ring, const T* buffer, unsigned int frames);
+    size_t readRingBuffer(size_t count);
     void clearBuffer();
+    bool openInputStream();
+    void closeInputStream();
+    void beginUtterance();
+    UtteranceBuffer endUtterance();
+    void beginUtteranceLocked(UtteranceBuffer utterance);
+    UtteranceBuffer endUtteranceLocked();
+    void captureSamples(const float* data, size_t count);
+    void drainContinuous(const float* data, size_t count, std::vector<UtteranceBuffer>& finished);
+    void writeHistory(const float* data, size_t count);
+    void startDrainThread();
+    void stopDrainThread();
+    void drainLoop();
+    void drainRingBuffer();
 
     std::unique_ptr<RtAudio> audio;
-    std::queue<std::vector<float>> audioQueue;
-    std::mutex audioMutex;
     
     unsigned int currentDeviceId;
     bool recording;
+    bool warmStream;
+    unsigned int preRollMs;
     
-    // Audio settings
+    // Audio settings; the device is opened at its own rate and channel count
+    // and the drain thread converts to this format
     const unsigned int sampleRate = 16000;  // Required for Whisper
     const unsigned int channels = 1;        // Mono recording
     const unsigned int bufferFrames = 1024; // Buffer size
+    const unsigned int ringSeconds = 2;     // Headroom before the drain thread must catch up
+    const unsigned int maxDeviceRate = 48000;     // Sizes the ring; faster devices get less headroom
+    const unsigned int maxDeviceChannels = 2;     // Further channels are not captured
+    unsigned int deviceRate;
+    unsigned int deviceChannels;
+    const unsigned int drainIntervalMs = 10;
+    const unsigned int continuousPreRollMs = 300;  // Minimum history so the onset is kept
+
+    // Real-time handoff: the audio callback only writes into the ring buffer,
+    // a drain thread appends samples to the current utterance off the audio thread.
+    // Exactly one ring exists, matching the stream format; swapped only while
+    // the stream and the drain thread are stopped.
+    std::unique_ptr<SpscRingBuffer<float>> ringBuffer;
+    std::unique_ptr<SpscRingBuffer<int16_t>> compactRingBuffer;
+    bool compactCapture;   // Requested format; guarded by audioMutex
+    bool compactStream;    // Format of the open stream
+    std::vector<int16_t> compactScratch;  // 16-bit ring reads before conversion
+    std::vector<float> drainScratch;   // Device format, interleaved
+    std::vector<float> converted;      // drainScratch at sampleRate, mono
+    Resampler resampler;               // Used only by the drain thread
+    CaptureArena arena;
+    UtteranceBuffer currentUtterance;
+    bool capturing;  // Drained audio goes to currentUtterance rather than history
+    mutable std::mutex audioMutex;  // Guards currentUtterance, capturing and history
+    std::mutex drainMutex;  // Serialises ring buffer consumers
+
+    std::unique_ptr<MelFrontend> melFrontend;  // Guarded by audioMutex
+    std::unique_ptr<VoiceActivityDetector> voiceActivity;  // Guarded by audioMutex
+
+    // Hands-free endpointing, run by the drain thread. Guarded by audioMutex.
+    bool continuous;
+    SpeechEndpointer endpointer;
+
+    // Pre-roll history, written by the drain thread while not capturing
+    std::vector<float> history;
+    size_t historyWrite;
+    size_t historyFilled;
+    std::thread drainThread;
+    std::atomic<bool> draining;
+    std::atomic<unsigned int> overflowCount;
+    std::atomic<size_t> droppedSamples;
     
     // Callbacks
     std::function<void()> onRecordingStart;
     std::function<void()> onRecordingStop;
+    std::function<void(UtteranceBuffer)> onUtterance;
 };
 
 } // namespace audio
@@ -1,10 +1,28 @@
 #include "audio/audio_processor.hpp"
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QCoreApplication>
 #include <stdexcept>
 #include <filesystem>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#include <fstream>
+#include <set>
+#include <string>
+#endif
 
 namespace whisper_client {
 namespace audio {
@@ -13,11 +31,21 @@ AudioProcessor::AudioProcessor()
     : QObject(nullptr)
     , ctx(nullptr)
     , modelManager(std::make_unique<ModelManager>())
+    , cancelGeneration(0)
+    , jobToken(0)
+    , maxResidentModels(2)
+    , loaderStopping(false)
+    , nThreads(std::max(1, std::min(detectPhysicalCores(), 8)))
+    , adaptiveContext(false)
     , modelLoaded(false)
+    , melCount(0)
 {
-    // Connect to model manager signals
+    // Connect to model manager signals; the old model keeps transcribing
+    // until the new one has loaded
     connect(modelManager.get(), &ModelManager::modelChanged,
-            [this](const QString&) { initializeModel(); });
+            [this](const QString&) {
+                requestModelLoad();
+            });
     
     checkModel();
 }
@@ -36,46 +64,175 @@ void AudioProcessor::checkModel() {
 }
 
 bool AudioProcessor::initializeModel() {
-    cleanup();  // Clean up any existing context
-
     try {
         if (!modelManager->isModelAvailable()) {
             qWarning() << "Whisper model not available";
             return false;
         }
+        return activateModel(modelManager->getModelPath());
+
+    } catch (const std::exception& e) {
+        qWarning() << "Error initializing whisper model:" << e.what();
+        return false;
+    }
+}
+
+void AudioProcessor::requestModelLoad() {
+    if (!modelManager->isModelAvailable()) {
+        qWarning() << "Whisper model not available";
+        emit modelLoadFailed(modelManager->getModelPath());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        pendingModelPath = modelManager->getModelPath();
+        loaderStopping = false;
+        if (!loaderThread.joinable()) {
+            loaderThread = std::thread(&AudioProcessor::loaderLoop, this);
+        }
+    }
+    loaderCondition.notify_one();
+}
+
+void AudioProcessor::setMaxResidentModels(int count) {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    maxResidentModels = static_cast<size_t>(std::max(1, count));
+    evictResidentModels();
+}
+
+void AudioProcessor::loaderLoop() {
+    while (true) {
+        QString modelPath;
+        {
+            std::unique_lock<std::mutex> lock(loaderMutex);
+            loaderCondition.wait(lock, [this]() {
+                return loaderStopping || !pendingModelPath.isEmpty();
+            });
+            if (loaderStopping) {
+                return;
+            }
+            modelPath = pendingModelPath;
+            pendingModelPath.clear();
+        }
+
+        try {
+            if (!activateModel(modelPath)) {
+                emit modelLoadFailed(modelPath);
+            }
+        } catch (const std::exception& e) {
+            qWarning() << "Error loading whisper model:" << e.what();
+            emit modelLoadFailed(modelPath);
+        }
+    }
+}
+
+void AudioProcessor::stopLoader() {
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        loaderStopping = true;
+        pendingModelPath.clear();
+    }
+    loaderCondition.notify_one();
+    if (loaderThread.joinable()) {
+        loaderThread.join();
+    }
+}
+
+whisper_context* AudioProcessor::loadContext(const QString& modelPath) {
+    whisper_context_params contextParams = whisper_context_default_params();
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    whisper_context* loaded = whisper_init_from_file_with_params(modelPath.toStdString().c_str(), contextParams);
+    if (!loaded) {
+        qWarning() << "Failed to initialize whisper context";
+        return nullptr;
+    }
+
+    qDebug() << "Whisper model loaded successfully in" << loadTimer.elapsed() << "ms";
+    return loaded;
+}
+
+bool AudioProcessor::activateModel(const QString& modelPath) {
+    auto resident = [this, &modelPath]() {
+        return std::find_if(residentModels.begin(), residentModels.end(),
+                            [&modelPath](const ResidentModel& model) { return model.path == modelPath; });
+    };
+
+    // Load outside contextMutex so the current model keeps decoding
+    bool needsLoad;
+    {
+        std::lock_guard<std::mutex> lock(contextMutex);
+        needsLoad = resident() == residentModels.end();
+    }
 
-        // Initialize whisper context
-        ctx = whisper_init_from_file(modelManager->getModelPath().toStdString().c_str());
-        if (!ctx) {
-            qWarning() << "Failed to initialize whisper context";
+    whisper_context* loaded = nullptr;
+    if (needsLoad) {
+        loaded = loadContext(modelPath);
+        if (!loaded) {
             return false;
         }
+    }
 
+    // Swap in between decodes
+    {
+        std::lock_guard<std::mutex> lock(contextMutex);
+        auto it = resident();
+        if (it == residentModels.end()) {
+            if (!loaded) {
+                return false;  // Evicted while we were not holding the lock
+            }
+            residentModels.push_front({modelPath, loaded});
+        } else {
+            if (loaded) {
+                whisper_free(loaded);  // Loaded concurrently by someone else
+            }
+            residentModels.splice(residentModels.begin(), residentModels, it);
+        }
+        ctx = residentModels.front().context;
+        melCount = whisper_model_n_mels(ctx);
         modelLoaded = true;
-        qDebug() << "Whisper model loaded successfully";
-        return true;
+        evictResidentModels();
+    }
 
-    } catch (const std::exception& e) {
-        qWarning() << "Error initializing whisper model:" << e.what();
-        return false;
+    qDebug() << "Active whisper model:" << modelPath;
+    emit modelReady();
+    return true;
+}
+
+void AudioProcessor::evictResidentModels() {
+    while (residentModels.size() > maxResidentModels) {
+        whisper_free(residentModels.back().context);
+        residentModels.pop_back();
     }
 }
 
 void AudioProcessor::cleanup() {
-    if (ctx) {
-        whisper_free(ctx);
-        ctx = nullptr;
+    stopLoader();
+    std::lock_guard<std::mutex> lock(contextMutex);
+    releaseContext();
+}
+
+void AudioProcessor::releaseContext() {
+    for (auto& model : residentModels) {
+        whisper_free(model.context);
     }
+    residentModels.clear();
+    ctx = nullptr;
+    melCount = 0;
     modelLoaded = false;
 }
 
-TranscriptionResult AudioProcessor::processAudio(const std::vector<float>& audioData) {
+TranscriptionResult AudioProcessor::processAudio(const UtteranceBuffer& utterance, CancelToken token) {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    jobToken = token;
     if (!modelLoaded || !ctx) {
         qWarning() << "Whisper model not loaded";
         return TranscriptionResult{};
     }
 
-    if (audioData.empty()) {
+    if (utterance.empty()) {
         qWarning() << "Empty audio data";
         return TranscriptionResult{};
     }
@@ -86,7 +243,7 @@ TranscriptionResult AudioProcessor::processAudio(const std::vector<float>& audio
 
     TranscriptionResult result;
     try {
-        result = transcribeAudio(audioData);
+        result = transcribeAudio(utterance, false);
     } catch (const std::exception& e) {
         qWarning() << "Error processing audio:" << e.what();
     }
@@ -98,25 +255,137 @@ TranscriptionResult AudioProcessor::processAudio(const std::vector<float>& audio
     return result;
 }
 
-TranscriptionResult AudioProcessor::transcribeAudio(const std::vector<float>& audioData) {
+TranscriptionResult AudioProcessor::processPartial(const UtteranceBuffer& window, CancelToken token) {
+    std::lock_guard<std::mutex> lock(contextMutex);
+    jobToken = token;
+    if (!modelLoaded || !ctx || window.empty()) {
+        return TranscriptionResult{};
+    }
+
+    // Provisional decodes do not toggle the processing indicator
+    try {
+        return transcribeAudio(window, true);
+    } catch (const std::exception& e) {
+        qWarning() << "Error processing partial audio:" << e.what();
+        return TranscriptionResult{};
+    }
+}
+
+void AudioProcessor::cancelTranscription() {
+    ++cancelGeneration;
+}
+
+bool AudioProcessor::abortCallback(void* userData) {
+    return static_cast<AudioProcessor*>(userData)->jobCancelled();
+}
+
+bool AudioProcessor::encoderBeginCallback(struct whisper_context* ctx, struct whisper_state* state, void* userData) {
+    (void)ctx;    // Unused
+    (void)state;  // Unused
+
+    // Returning false skips the encoder entirely
+    return !static_cast<AudioProcessor*>(userData)->jobCancelled();
+}
+
+void AudioProcessor::newSegmentCallback(struct whisper_context* ctx, struct whisper_state* state, int nNew, void* userData) {
+    (void)state;
+    auto* self = static_cast<AudioProcessor*>(userData);
+    const int total = whisper_full_n_segments(ctx);
+    for (int i = std::max(0, total - nNew); i < total; ++i) {
+        const QString text = QString::fromUtf8(whisper_full_get_segment_text(ctx, i)).trimmed();
+        if (!text.isEmpty()) {
+            self->onSegment(text,
+                            double(whisper_full_get_segment_t0(ctx, i)) * 0.01,
+                            double(whisper_full_get_segment_t1(ctx, i)) * 0.01);
+        }
+    }
+}
+
+TranscriptionResult AudioProcessor::transcribeAudio(const UtteranceBuffer& utterance, bool partial) {
     TranscriptionResult result;
+    if (jobCancelled()) {
+        result.cancelled = true;
+        return result;
+    }
+
+    // Samples before the decode offset were already transcribed, and silence
+    // outside the detected speech range is not worth encoding
+    const size_t offsetSamples = std::min(utterance.size(),
+        static_cast<size_t>(utterance.getDecodeOffsetMs()) * WHISPER_SAMPLE_RATE / 1000);
+    const size_t windowBegin = std::max(offsetSamples, utterance.getSpeechBegin());
+    const size_t windowEnd = std::max(windowBegin, std::min(utterance.size(), utterance.getSpeechEnd()));
+    const size_t remaining = windowEnd - windowBegin;
+    const int offsetMs = static_cast<int>(windowBegin * 1000 / WHISPER_SAMPLE_RATE);
+    const int durationMs = static_cast<int>(remaining * 1000 / WHISPER_SAMPLE_RATE);
+    if (durationMs < 10) {
+        return result;  // Below one mel frame; nothing to decode
+    }
 
     // Initialize whisper parameters
     whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
     params.print_progress = false;
     params.print_special = false;
     params.print_realtime = false;
-    params.print_timestamps = true;
+    params.print_timestamps = !partial;
     params.translate = false;
     params.language = language;
-    params.n_threads = N_THREADS;
-    params.offset_ms = 0;
+    params.n_threads = nThreads;
+    params.offset_ms = offsetMs;    // Timestamps stay relative to the start of the buffer
+    params.duration_ms = durationMs;
+
+    // Short-clip fast path. Partials keep segmentation, which the streaming
+    // commit logic relies on.
+    if (adaptiveContext) {
+        params.audio_ctx = adaptiveAudioContext(remaining);
+        if (isShortClip(remaining)) {
+            params.single_segment = !partial;
+            params.no_context = true;
+        }
+    }
+    if (partial) {
+        params.no_context = true;  // Earlier windows are not a reliable prompt
+    }
+
+    // Cancellation: checked between encoder runs and during decoding
+    params.encoder_begin_callback = &AudioProcessor::encoderBeginCallback;
+    params.encoder_begin_callback_user_data = this;
+    params.abort_callback = &AudioProcessor::abortCallback;
+    params.abort_callback_user_data = this;
+
+    // Stream finished segments out while later ones are still decoding
+    if (!partial && onSegment) {
+        params.new_segment_callback = &AudioProcessor::newSegmentCallback;
+        params.new_segment_callback_user_data = this;
+    }
 
-    // Process the audio
-    if (whisper_full(ctx, params, audioData.data(), audioData.size()) != 0) {
+    int status;
+    const MelSpectrogram& mel = utterance.getMel();
+    if (!mel.empty() && mel.nMel == whisper_model_n_mels(ctx) &&
+        whisper_set_mel(ctx, mel.data.data(), mel.nLen, mel.nMel) == 0) {
+        // Spectrogram was built during capture; with no samples whisper_full
+        // skips its own mel pass and goes straight to the encoder. The set mel
+        // includes the trailing padding, so bound decoding to the real audio.
+        params.duration_ms = std::max(10, std::min(durationMs, mel.nLenOrg * 10 - offsetMs));
+        status = whisper_full(ctx, params, nullptr, 0);
+    } else if (utterance.isCompact()) {
+        // 16-bit recordings become float only for the duration of the decode
+        std::vector<float> pcm(utterance.size());
+        utterance.copySamples(0, pcm.size(), pcm.data());
+        status = whisper_full(ctx, params, pcm.data(), static_cast<int>(pcm.size()));
+    } else {
+        // Process the audio straight out of the capture buffer
+        status = whisper_full(ctx, params, utterance.data(), static_cast<int>(utterance.size()));
+    }
+    if (jobCancelled()) {
+        qDebug() << "Transcription cancelled";
+        result.cancelled = true;
+        return result;
+    }
+    if (status != 0) {
         qWarning() << "Failed to process audio";
         return result;
     }
+    result.decodedSeconds = params.duration_ms / 1000.0;
 
     // Get number of segments
     const int n_segments = whisper_full_n_segments(ctx);
@@ -125,16 +394,17 @@ TranscriptionResult AudioProcessor::transcribeAudio(const std::vector<float>& au
     QString fullText;
     for (int i = 0; i < n_segments; ++i) {
         // Get segment text
-        const char* text = whisper_full_get_segment_text(ctx, i);
-        fullText += QString::fromUtf8(text).trimmed() + " ";
+        const QString text = QString::fromUtf8(whisper_full_get_segment_text(ctx, i)).trimmed();
+        fullText += text + " ";
+        result.segmentTexts.push_back(text);
 
         // Get timing
         int64_t start = whisper_full_get_segment_t0(ctx, i);
         int64_t end = whisper_full_get_segment_t1(ctx, i);
         
-        // Convert timestamps from tokens to seconds
-        double start_sec = double(start) * 0.02; // whisper uses 20ms per token
-        double end_sec = double(end) * 0.02;
+        // Convert timestamps to seconds; whisper reports them in 10 ms units
+        double start_sec = double(start) * 0.01;
+        double end_sec = double(end) * 0.01;
         
         result.segments.push_back({start_sec, end_sec});
     }
@@ -151,6 +421,202 @@ TranscriptionResult AudioProcessor::transcribeAudio(const std::vector<float>& au
     return result;
 }
 
+void AudioProcessor::setThreadCount(int threads) {
+    if (threads > 0) {
+        nThreads = threads;
+        qDebug() << "Whisper threads set to:" << threads;
+    }
+}
+
+int AudioProcessor::getThreadCount() const {
+    return nThreads;
+}
+
+int AudioProcessor::detectPhysicalCores() {
+    const int logical = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+#ifdef _WIN32
+    // One RelationProcessorCore entry per physical core, regardless of SMT
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length)) {
+        int cores = 0;
+        for (const auto& entry : info) {
+            if (entry.Relationship == RelationProcessorCore) {
+                ++cores;
+            }
+        }
+        if (cores > 0) {
+            return cores;
+        }
+    }
+#elif defined(__APPLE__)
+    int cores = 0;
+    size_t size = sizeof(cores);
+    if (sysctlbyname("hw.physicalcpu", &cores, &size, nullptr, 0) == 0 && cores > 0) {
+        return cores;
+    }
+#elif defined(__linux__)
+    // SMT siblings share a (package, core) pair in sysfs
+    std::set<std::pair<long, long>> cores;
+    const long configured = sysconf(_SC_NPROCESSORS_CONF);
+    for (long cpu = 0; cpu < configured; ++cpu) {
+        const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        std::ifstream packageFile(topology + "physical_package_id");
+        std::ifstream coreFile(topology + "core_id");
+        long package = -1;
+        long core = -1;
+        if (packageFile >> package && coreFile >> core) {
+            cores.emplace(package, core);
+        }
+    }
+    if (!cores.empty()) {
+        return std::min(logical, static_cast<int>(cores.size()));
+    }
+#endif
+
+    return logical;
+}
+
+int AudioProcessor::calibrateThreadCount(CancelToken token) {
+    // Trials run on a state of their own, so they leave no prompt context
+    // behind for the next real decode
+    whisper_context* calibrated;
+    whisper_state* state;
+    {
+        std::lock_guard<std::mutex> lock(contextMutex);
+        if (!modelLoaded || !ctx) {
+            return 0;
+        }
+        calibrated = ctx;
+        state = whisper_init_state(ctx);
+    }
+    if (!state) {
+        qWarning() << "Thread calibration failed: no state";
+        return 0;
+    }
+
+    const int physical = detectPhysicalCores();
+    const int logical = std::max(physical, static_cast<int>(std::thread::hardware_concurrency()));
+
+    // Small counts one by one, then every other count up to the logical cores
+    std::vector<int> candidates;
+    for (int t = 1; t <= logical; t += (t < 4 ? 1 : 2)) {
+        candidates.push_back(t);
+    }
+    candidates.push_back(physical);
+    candidates.push_back(logical);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Two seconds of a voiced-like tone decoded end to end, with the decoder
+    // capped so every trial does the same amount of work
+    std::vector<float> clip(WHISPER_SAMPLE_RATE * 2);
+    for (size_t i = 0; i < clip.size(); ++i) {
+        const double t = double(i) / WHISPER_SAMPLE_RATE;
+        clip[i] = static_cast<float>(0.1 * std::sin(2.0 * 3.14159265358979323846 * 220.0 * t) *
+                                     (0.6 + 0.4 * std::sin(2.0 * 3.14159265358979323846 * 3.0 * t)));
+    }
+
+    // One decode per call, with contextMutex held only for its duration so
+    // model swaps and other callers get in between trials
+    enum class Trial { Ok, Failed, Cancelled };
+    auto runTrial = [&](int threads, double* ms) {
+        std::lock_guard<std::mutex> lock(contextMutex);
+        jobToken = token;
+        if (jobCancelled() || ctx != calibrated) {
+            return Trial::Cancelled;
+        }
+
+        whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+        params.print_progress = false;
+        params.print_special = false;
+        params.print_realtime = false;
+        params.print_timestamps = false;
+        params.language = language;
+        params.n_threads = threads;
+        params.no_context = true;
+        params.no_timestamps = true;
+        params.single_segment = true;
+        params.max_tokens = 16;
+        params.encoder_begin_callback = &AudioProcessor::encoderBeginCallback;
+        params.encoder_begin_callback_user_data = this;
+        params.abort_callback = &AudioProcessor::abortCallback;
+        params.abort_callback_user_data = this;
+
+        const auto start = std::chrono::steady_clock::now();
+        const int status = whisper_full_with_state(ctx, state, params, clip.data(), static_cast<int>(clip.size()));
+        *ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (jobCancelled()) {
+            return Trial::Cancelled;
+        }
+        return status == 0 ? Trial::Ok : Trial::Failed;
+    };
+
+    int bestThreads = 0;
+    double bestMs = 0.0;
+    int slowerInARow = 0;
+    double ms = 0.0;
+    Trial trial = runTrial(physical, &ms);  // Warm-up
+    for (size_t i = 0; trial == Trial::Ok && i < candidates.size(); ++i) {
+        const int threads = candidates[i];
+        double fastestMs = 0.0;
+        for (int run = 0; run < 2 && trial == Trial::Ok; ++run) {
+            trial = runTrial(threads, &ms);
+            fastestMs = (run == 0) ? ms : std::min(fastestMs, ms);
+        }
+        if (trial != Trial::Ok) {
+            break;
+        }
+        qDebug() << "Calibration:" << threads << "threads," << fastestMs << "ms";
+
+        if (bestMs == 0.0 || fastestMs < bestMs) {
+            bestMs = fastestMs;
+            bestThreads = threads;
+            slowerInARow = 0;
+        } else if (++slowerInARow >= 2) {
+            break;  // Past the knee; more threads only contend
+        }
+    }
+
+    whisper_free_state(state);
+
+    if (trial == Trial::Cancelled) {
+        qDebug() << "Thread calibration cancelled";
+        return 0;
+    }
+    if (trial == Trial::Failed || bestThreads == 0) {
+        qWarning() << "Thread calibration failed";
+        return 0;
+    }
+    qDebug() << "Calibrated whisper threads:" << bestThreads << "(" << bestMs << "ms per decode)";
+    return bestThreads;
+}
+
+void AudioProcessor::setAdaptiveContext(bool enabled) {
+    adaptiveContext = enabled;
+    qDebug() << "Adaptive audio context" << (enabled ? "enabled" : "disabled");
+}
+
+bool AudioProcessor::isAdaptiveContextEnabled() const {
+    return adaptiveContext;
+}
+
+int AudioProcessor::adaptiveAudioContext(size_t samples) {
+    // Encoder positions needed to cover the clip, plus a safety margin
+    const size_t needed = (samples * AUDIO_CTX_PER_SECOND + WHISPER_SAMPLE_RATE - 1) / WHISPER_SAMPLE_RATE
+                        + AUDIO_CTX_MARGIN;
+    if (needed >= static_cast<size_t>(FULL_AUDIO_CTX)) {
+        return 0;
+    }
+    return std::max(static_cast<int>(needed), MIN_AUDIO_CTX);
+}
+
+bool AudioProcessor::isShortClip(size_t samples) {
+    return samples < static_cast<size_t>(SHORT_CLIP_SECONDS) * WHISPER_SAMPLE_RATE;
+}
+
 void AudioProcessor::setProcessingStartCallback(std::function<void()> callback) {
     onProcessingStart = std::move(callback);
 }
@@ -159,5 +625,9 @@ void AudioProcessor::setProcessingEndCallback(std::function<void()> callback) {
     onProcessingEnd = std::move(callback);
 }
 
+void AudioProcessor::setSegmentCallback(SegmentCallback callback) {
+    onSegment = std::move(callback);
+}
+
 } // namespace audio
 } // namespace whisper_client
\ No newline at end of file
@@ -4,9 +4,16 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <atomic>
+#include <list>
+#include <thread>
+#include <condition_variable>
 #include <QtCore/QString>
+#include <QtCore/QMetaType>
 #include "whisper.h"
 #include "audio/model_manager.hpp"
+#include "audio/utterance_buffer.hpp"
 
 namespace whisper_client {
 namespace audio {
@@ -15,8 +22,13 @@ struct TranscriptionResult {
     QString text;
     QString language;
     std::vector<std::pair<double, double>> segments;  // start_time, end_time pairs
+    std::vector<QString> segmentTexts;                // One per entry in segments
+    double decodedSeconds = 0.0;  // Audio whisper actually decoded; 0 if no decode ran
+    bool cancelled = false;
 };
 
+// processAudio may run on a worker thread while the model is (re)loaded from
+// the GUI thread; contextMutex serialises access to the whisper context.
 class AudioProcessor : public QObject {
     Q_OBJECT
 
@@ -24,39 +36,125 @@ public:
     AudioProcessor();
     ~AudioProcessor();
 
+    // Cancellation is per job: a job runs with the token that was current
+    // when it was taken off the queue, and cancelTranscription() invalidates
+    // every token handed out so far. A cancel that lands after dequeue but
+    // before whisper_full starts therefore still stops that job. Thread-safe.
+    using CancelToken = unsigned int;
+    CancelToken cancellationToken() const { return cancelGeneration.load(); }
+    void cancelTranscription();
+
     // Processing control
-    TranscriptionResult processAudio(const std::vector<float>& audioData);
+    TranscriptionResult processAudio(const UtteranceBuffer& utterance, CancelToken token);
+    TranscriptionResult processPartial(const UtteranceBuffer& window, CancelToken token);
     void cleanup();
 
+    // Inference threads
+    void setThreadCount(int threads);
+    int getThreadCount() const;
+    static int detectPhysicalCores();
+
+    // Times a short synthetic decode, encoder and decoder, at several thread
+    // counts and returns the fastest. Returns 0 if no model is loaded, the
+    // model changes, or token is cancelled. Runs for several seconds but holds
+    // the context only for one trial at a time.
+    int calibrateThreadCount(CancelToken token);
+
+    bool isModelLoaded() const { return modelLoaded; }
+    int getMelCount() const { return melCount; }  // Mel bins of the active model, 0 if none; lock-free
+
+    // Short-clip fast path: shrink the encoder window to the clip length and
+    // decode short clips as a single segment without prompt context
+    void setAdaptiveContext(bool enabled);
+    bool isAdaptiveContextEnabled() const;
+    static int adaptiveAudioContext(size_t samples);  // 0 means the full 30 s window
+    static bool isShortClip(size_t samples);
+
     // Model management
     ModelManager* getModelManager() { return modelManager.get(); }
 
+    // Loads the current model on a background thread while the active one
+    // keeps serving, then swaps it in between decodes. Recently used models
+    // stay resident so switching back to them is immediate.
+    void requestModelLoad();
+    void setMaxResidentModels(int count);
+
     // Callbacks
     void setProcessingStartCallback(std::function<void()> callback);
     void setProcessingEndCallback(std::function<void()> callback);
 
+    // Invoked on the decoding thread for each segment of a final decode as
+    // soon as whisper finalises it, before processAudio returns
+    using SegmentCallback = std::function<void(const QString& text, double startTime, double endTime)>;
+    void setSegmentCallback(SegmentCallback callback);
+
+signals:
+    void modelReady();
+    void modelLoadFailed(const QString& modelPath);
+
 private slots:
     bool initializeModel();
     void checkModel();
 
 private:
-    TranscriptionResult transcribeAudio(const std::vector<float>& audioData);
+    TranscriptionResult transcribeAudio(const UtteranceBuffer& utterance, bool partial);
+    bool jobCancelled() const { return jobToken != cancelGeneration.load(); }
+    void releaseContext();
+    bool activateModel(const QString& modelPath);
+    void evictResidentModels();
+    void loaderLoop();
+    void stopLoader();
+    static whisper_context* loadContext(const QString& modelPath);
+    static bool abortCallback(void* userData);
+    static bool encoderBeginCallback(struct whisper_context* ctx, struct whisper_state* state, void* userData);
+    static void newSegmentCallback(struct whisper_context* ctx, struct whisper_state* state, int nNew, void* userData);
     
     struct whisper_context* ctx;
     std::unique_ptr<ModelManager> modelManager;
+    std::mutex contextMutex;
+    std::atomic<CancelToken> cancelGeneration;
+    CancelToken jobToken;  // Token of the job inside transcribeAudio; guarded by contextMutex
+
+    // Resident contexts, most recently used first; ctx is the front entry.
+    // Guarded by contextMutex.
+    struct ResidentModel {
+        QString path;
+        whisper_context* context;
+    };
+    std::list<ResidentModel> residentModels;
+    size_t maxResidentModels;
+
+    // Background loader; only the most recent request is kept
+    std::thread loaderThread;
+    std::mutex loaderMutex;
+    std::condition_variable loaderCondition;
+    QString pendingModelPath;
+    bool loaderStopping;
 
     // Processing settings
     const int WHISPER_SAMPLE_RATE = 16000;
-    const int N_THREADS = 4;         // Number of processing threads
+    std::atomic<int> nThreads;       // Number of processing threads
+    std::atomic<bool> adaptiveContext;
     const char* language = "en";     // Default language
     
     // Callbacks
     std::function<void()> onProcessingStart;
     std::function<void()> onProcessingEnd;
+    SegmentCallback onSegment;
+    
+    // Encoder window: 1500 positions cover 30 s, i.e. 50 per second
+    static constexpr int FULL_AUDIO_CTX = 1500;
+    static constexpr int AUDIO_CTX_PER_SECOND = 50;
+    static constexpr int AUDIO_CTX_MARGIN = 64;    // ~1.3 s past the end of the clip
+    static constexpr int MIN_AUDIO_CTX = 256;      // Very small windows hurt accuracy
+    static constexpr int SHORT_CLIP_SECONDS = 10;  // Single segment, no context below this
     
     // Internal state
-    bool modelLoaded;
+    std::atomic<bool> modelLoaded;
+    std::atomic<int> melCount;  // Recorded at swap so the GUI never waits on contextMutex
 };
 
 } // namespace audio
-} // namespace whisper_client
\ No newline at end of file
+} // namespace whisper_client
+
+Q_DECLARE_METATYPE(whisper_client::audio::TranscriptionResult)
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "audio/context_benchmark.hpp"
+#include "audio/audio_processor.hpp"
+#include "audio/model_manager.hpp"
+#include "whisper.h"
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#include <QtCore/QRegularExpression>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace whisper_client {
+namespace audio {
+
+namespace {
+
+// Minimal RIFF/WAVE reader: 16-bit PCM or 32-bit float, any channel count
+// (downmixed), 16 kHz only
+bool readWav(const QString& path, std::vector<float>& samples, QString& error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = "cannot open " + path;
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+    if (bytes.size() < 12 || !bytes.startsWith("RIFF") || bytes.mid(8, 4) != "WAVE") {
+        error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    auto readU16 = [&](int offset) {
+        return static_cast<quint16>(static_cast<quint8>(bytes[offset]) |
+                                    (static_cast<quint8>(bytes[offset + 1]) << 8));
+    };
+    auto readU32 = [&](int offset) {
+        return static_cast<quint32>(readU16(offset)) | (static_cast<quint32>(readU16(offset + 2)) << 16);
+    };
+
+    quint16 format = 0, channels = 0, bits = 0;
+    quint32 rate = 0;
+    int offset = 12;
+    while (offset + 8 <= bytes.size()) {
+        const QByteArray id = bytes.mid(offset, 4);
+        const quint32 size = readU32(offset + 4);
+        const int body = offset + 8;
+        if (id == "fmt " && size >= 16 && body + 16 <= bytes.size()) {
+            format = readU16(body);
+            channels = readU16(body + 2);
+            rate = readU32(body + 4);
+            bits = readU16(body + 14);
+        } else if (id == "data") {
+            if (rate != 16000 || channels == 0) {
+                error = QString("expected 16 kHz audio, got %1 Hz").arg(rate);
+                return false;
+            }
+            const bool pcm16 = (format == 1 && bits == 16);
+            const bool float32 = (format == 3 && bits == 32);
+            if (!pcm16 && !float32) {
+                error = "only 16-bit PCM and 32-bit float WAV files are supported";
+                return false;
+            }
+            const int frameBytes = channels * bits / 8;
+            const int frames = std::min<int>(size, bytes.size() - body) / frameBytes;
+            samples.resize(frames);
+            for (int i = 0; i < frames; ++i) {
+                float sum = 0.0f;
+                for (int c = 0; c < channels; ++c) {
+                    const int at = body + i * frameBytes + c * bits / 8;
+                    if (pcm16) {
+                        sum += static_cast<qint16>(readU16(at)) / 32768.0f;
+                    } else {
+                        quint32 raw = readU32(at);
+                        float value;
+                        std::memcpy(&value, &raw, sizeof(value));
+                        sum += value;
+                    }
+                }
+                samples[i] = sum / channels;
+            }
+            return true;
+        }
+        offset = body + static_cast<int>(size + (size & 1));
+    }
+
+    error = "no data chunk";
+    return false;
+}
+
+QStringList words(const QString& text) {
+    static const QRegularExpression nonWord("[^\\w']+");
+    return text.toLower().split(nonWord, Qt::SkipEmptyParts);
+}
+
+double wordErrorRate(const QString& reference, const QString& hypothesis) {
+    const QStringList ref = words(reference);
+    const QStringList hyp = words(hypothesis);
+    if (ref.isEmpty()) {
+        return hyp.isEmpty() ? 0.0 : 1.0;
+    }
+
+    // Levenshtein distance over words
+    std::vector<int> previous(hyp.size() + 1), current(hyp.size() + 1);
+    for (int j = 0; j <= hyp.size(); ++j) {
+        previous[j] = j;
+    }
+    for (int i = 1; i <= ref.size(); ++i) {
+        current[0] = i;
+        for (int j = 1; j <= hyp.size(); ++j) {
+            const int substitution = previous[j - 1] + (ref[i - 1] == hyp[j - 1] ? 0 : 1);
+            current[j] = std::min({previous[j] + 1, current[j - 1] + 1, substitution});
+        }
+        std::swap(previous, current);
+    }
+    return double(previous[hyp.size()]) / ref.size();
+}
+
+struct Decode {
+    QString text;
+    double ms = 0.0;
+};
+
+Decode decode(whisper_context* ctx, const std::vector<float>& samples, size_t count,
+              int threads, bool adaptive) {
+    whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    params.print_progress = false;
+    params.print_special = false;
+    params.print_realtime = false;
+    params.print_timestamps = false;
+    params.language = "en";
+    params.n_threads = threads;
+    if (adaptive) {
+        params.audio_ctx = AudioProcessor::adaptiveAudioContext(count);
+        if (AudioProcessor::isShortClip(count)) {
+            params.single_segment = true;
+            params.no_context = true;
+        }
+    }
+
+    Decode result;
+    const auto start = std::chrono::steady_clock::now();
+    if (whisper_full(ctx, params, samples.data(), static_cast<int>(count)) != 0) {
+        return result;
+    }
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < whisper_full_n_segments(ctx); ++i) {
+        result.text += QString::fromUtf8(whisper_full_get_segment_text(ctx, i)).trimmed() + " ";
+    }
+    result.text = result.text.trimmed();
+    return result;
+}
+
+} // namespace
+
+int runContextBenchmark(const QString& wavPath, int threads) {
+    std::vector<float> samples;
+    QString error;
+    if (!readWav(wavPath, samples, error)) {
+        std::fprintf(stderr, "Benchmark: %s\n", error.toStdString().c_str());
+        return 1;
+    }
+
+    if (threads <= 0) {
+        threads = std::max(1, std::min(AudioProcessor::detectPhysicalCores(), 8));
+    }
+
+    // Keep whisper's own logging out of the table
+    whisper_log_set([](enum ggml_log_level, const char*, void*) {}, nullptr);
+
+    const double clipSeconds[] = {1.0, 2.0, 4.0, 6.0, 10.0, 20.0};
+    ModelManager modelManager;
+    bool anyModel = false;
+
+    std::printf("%-8s %6s %9s %9s %8s %9s %7s\n",
+                "model", "clip_s", "audio_ctx", "full_ms", "fast_ms", "speedup", "wer_%");
+    for (const QString& model : modelManager.getAvailableModels()) {
+        const QString path = modelManager.getModelPath(model);
+        if (!QFile::exists(path)) {
+            continue;
+        }
+
+        whisper_context* ctx = whisper_init_from_file_with_params(
+            path.toStdString().c_str(), whisper_context_default_params());
+        if (!ctx) {
+            std::fprintf(stderr, "Benchmark: failed to load %s\n", path.toStdString().c_str());
+            continue;
+        }
+        anyModel = true;
+
+        // Warm-up so the first row does not pay for allocation
+        decode(ctx, samples, std::min<size_t>(samples.size(), WHISPER_SAMPLE_RATE), threads, false);
+
+        for (double seconds : clipSeconds) {
+            const size_t count = static_cast<size_t>(seconds * WHISPER_SAMPLE_RATE);
+            if (count > samples.size()) {
+                break;
+            }
+
+            const Decode full = decode(ctx, samples, count, threads, false);
+            const Decode fast = decode(ctx, samples, count, threads, true);
+            const int audioCtx = AudioProcessor::adaptiveAudioContext(count);
+            std::printf("%-8s %6.1f %9d %9.0f %8.0f %8.2fx %7.1f\n",
+                        model.toStdString().c_str(), seconds,
+                        audioCtx > 0 ? audioCtx : 1500,
+                        full.ms, fast.ms,
+                        fast.ms > 0.0 ? full.ms / fast.ms : 0.0,
+                        100.0 * wordErrorRate(full.text, fast.text));
+        }
+
+        whisper_free(ctx);
+    }
+
+    if (!anyModel) {
+        std::fprintf(stderr, "Benchmark: no downloaded models found\n");
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QtCore/QString>
+
+namespace whisper_client {
+namespace audio {
+
+// Offline benchmark for the short-clip fast path. For every downloaded model
+// tier, cuts clips of increasing length from a 16 kHz WAV file and decodes
+// each with the full 30 s encoder window and with the adaptive one. Prints
+// latency for both and the word error rate of the adaptive transcript
+// against the full-window transcript. Returns a process exit code.
+int runContextBenchmark(const QString& wavPath, int threads);
+
+} // namespace audio
+} // namespace whisper_client
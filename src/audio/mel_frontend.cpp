@@ -0,0 +1,191 @@
+#include "audio/mel_frontend.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace whisper_client {
+namespace audio {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Slaney mel scale, as used by librosa and therefore by whisper's filters
+double hzToMel(double hz) {
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / (200.0 / 3.0);
+    const double logStep = std::log(6.4) / 27.0;
+    return hz < minLogHz ? hz / (200.0 / 3.0) : minLogMel + std::log(hz / minLogHz) / logStep;
+}
+
+double melToHz(double mel) {
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / (200.0 / 3.0);
+    const double logStep = std::log(6.4) / 27.0;
+    return mel < minLogMel ? mel * (200.0 / 3.0) : minLogHz * std::exp(logStep * (mel - minLogMel));
+}
+
+} // namespace
+
+MelFrontend::MelFrontend(int nMel)
+    : nMel(nMel)
+    , cosTable(static_cast<size_t>(N_FFT) * FRAME_SIZE)
+    , sinTable(static_cast<size_t>(N_FFT) * FRAME_SIZE)
+    , windowStart(0)
+    , totalSamples(0)
+    , nextFrame(0)
+    , finishing(false)
+    , frameScratch(FRAME_SIZE)
+    , powerScratch(N_FFT)
+    , maxValue(-10.0f)
+{
+    // Periodic Hann window folded into the DFT basis
+    for (int k = 0; k < N_FFT; ++k) {
+        for (int j = 0; j < FRAME_SIZE; ++j) {
+            const double hann = 0.5 * (1.0 - std::cos(2.0 * PI * j / FRAME_SIZE));
+            const double theta = 2.0 * PI * k * j / FRAME_SIZE;
+            cosTable[k * FRAME_SIZE + j] = static_cast<float>(hann * std::cos(theta));
+            sinTable[k * FRAME_SIZE + j] = static_cast<float>(hann * std::sin(theta));
+        }
+    }
+    buildFilters();
+}
+
+void MelFrontend::setMelCount(int count) {
+    if (count != nMel && count > 0) {
+        nMel = count;
+        buildFilters();
+        reset();
+    }
+}
+
+void MelFrontend::buildFilters() {
+    filters.assign(static_cast<size_t>(nMel) * N_FFT, 0.0f);
+
+    const double melMin = hzToMel(0.0);
+    const double melMax = hzToMel(SAMPLE_RATE / 2.0);
+    std::vector<double> hz(nMel + 2);
+    for (int i = 0; i < nMel + 2; ++i) {
+        hz[i] = melToHz(melMin + (melMax - melMin) * i / (nMel + 1));
+    }
+
+    for (int m = 0; m < nMel; ++m) {
+        const double norm = 2.0 / (hz[m + 2] - hz[m]);
+        for (int k = 0; k < N_FFT; ++k) {
+            const double freq = double(k) * SAMPLE_RATE / FRAME_SIZE;
+            const double lower = (freq - hz[m]) / (hz[m + 1] - hz[m]);
+            const double upper = (hz[m + 2] - freq) / (hz[m + 2] - hz[m + 1]);
+            const double weight = std::max(0.0, std::min(lower, upper));
+            filters[m * N_FFT + k] = static_cast<float>(weight * norm);
+        }
+    }
+}
+
+void MelFrontend::reset() {
+    head.clear();
+    window.clear();
+    windowStart = 0;
+    totalSamples = 0;
+    nextFrame = 0;
+    finishing = false;
+    frames.clear();
+    maxValue = -10.0f;
+}
+
+void MelFrontend::addSamples(const float* samples, size_t count) {
+    if (head.size() < static_cast<size_t>(PAD + 1)) {
+        const size_t take = std::min(count, PAD + 1 - head.size());
+        head.insert(head.end(), samples, samples + take);
+    }
+    window.insert(window.end(), samples, samples + count);
+    totalSamples += static_cast<long long>(count);
+
+    while (frameReady(nextFrame)) {
+        computeFrame(nextFrame++);
+    }
+
+    // Drop samples no later frame can reach, in batches to keep erase cheap
+    const long long keepFrom = nextFrame * FRAME_STEP - PAD;
+    if (keepFrom - windowStart > 8 * FRAME_SIZE) {
+        window.erase(window.begin(), window.begin() + (keepFrom - windowStart));
+        windowStart = keepFrom;
+    }
+}
+
+bool MelFrontend::frameReady(long long frame) const {
+    // The window ends at sample frame * FRAME_STEP + PAD; the reflect padding
+    // needs samples 1..PAD
+    return frame * FRAME_STEP + PAD <= totalSamples && totalSamples > PAD;
+}
+
+float MelFrontend::sampleAt(long long index) const {
+    if (index < 0) {
+        const size_t mirrored = static_cast<size_t>(-index);
+        return mirrored < head.size() ? head[mirrored] : 0.0f;
+    }
+    if (index >= totalSamples) {
+        return 0.0f;  // Trailing zero padding
+    }
+    return window[static_cast<size_t>(index - windowStart)];
+}
+
+void MelFrontend::computeFrame(long long frame) {
+    const long long first = frame * FRAME_STEP - PAD;
+    for (int j = 0; j < FRAME_SIZE; ++j) {
+        frameScratch[j] = sampleAt(first + j);
+    }
+
+    // Power spectrum of the windowed frame
+    for (int k = 0; k < N_FFT; ++k) {
+        const float* c = &cosTable[k * FRAME_SIZE];
+        const float* s = &sinTable[k * FRAME_SIZE];
+        float re = 0.0f;
+        float im = 0.0f;
+        for (int j = 0; j < FRAME_SIZE; ++j) {
+            re += frameScratch[j] * c[j];
+            im += frameScratch[j] * s[j];
+        }
+        powerScratch[k] = re * re + im * im;
+    }
+
+    for (int m = 0; m < nMel; ++m) {
+        const float* filter = &filters[m * N_FFT];
+        double sum = 0.0;
+        for (int k = 0; k < N_FFT; ++k) {
+            sum += powerScratch[k] * filter[k];
+        }
+        const float value = static_cast<float>(std::log10(std::max(sum, 1e-10)));
+        frames.push_back(value);
+        maxValue = std::max(maxValue, value);
+    }
+}
+
+MelSpectrogram MelFrontend::finish() {
+    MelSpectrogram mel;
+    mel.nMel = nMel;
+    mel.nLen = static_cast<int>((totalSamples + TRAILING_PAD_SECONDS * SAMPLE_RATE) / FRAME_STEP);
+    mel.nLenOrg = static_cast<int>(std::max<long long>(0, 1 + (totalSamples + PAD - FRAME_SIZE) / FRAME_STEP));
+
+    // Frames that still overlap real audio; everything after is silence
+    finishing = true;
+    const long long audioFrames = std::min<long long>((totalSamples + PAD) / FRAME_STEP + 1, mel.nLen);
+    while (nextFrame < audioFrames) {
+        computeFrame(nextFrame++);
+    }
+
+    // Clamp to 80 dB below the peak and rescale, then transpose to mel-major
+    const float floor = maxValue - 8.0f;
+    const float silence = (std::max(-10.0f, floor) + 4.0f) / 4.0f;
+    mel.data.assign(static_cast<size_t>(nMel) * mel.nLen, silence);
+    for (long long i = 0; i < nextFrame && i < mel.nLen; ++i) {
+        for (int m = 0; m < nMel; ++m) {
+            const float value = frames[static_cast<size_t>(i) * nMel + m];
+            mel.data[static_cast<size_t>(m) * mel.nLen + i] = (std::max(value, floor) + 4.0f) / 4.0f;
+        }
+    }
+
+    reset();
+    return mel;
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace whisper_client {
+namespace audio {
+
+// Log-mel spectrogram in the layout whisper_set_mel expects: nMel rows of
+// nLen frames each. nLen includes whisper's 30 s of trailing padding;
+// nLenOrg counts only the frames that cover real audio.
+struct MelSpectrogram {
+    std::vector<float> data;
+    int nMel = 0;
+    int nLen = 0;
+    int nLenOrg = 0;
+
+    bool empty() const { return data.empty(); }
+};
+
+// Incremental version of whisper.cpp's log-mel frontend (400-sample Hann
+// window, 160-sample hop, Slaney mel filters, reflect padding at the start).
+// Frames are computed as soon as their window is complete, so by the time a
+// recording stops only the last few frames and the normalisation remain.
+class MelFrontend {
+public:
+    explicit MelFrontend(int nMel = 80);
+
+    void setMelCount(int nMel);
+    int melCount() const { return nMel; }
+
+    void reset();
+    void addSamples(const float* samples, size_t count);
+    size_t sampleCount() const { return static_cast<size_t>(totalSamples); }
+
+    // Completes the spectrogram for everything fed since reset()
+    MelSpectrogram finish();
+
+private:
+    static constexpr int SAMPLE_RATE = 16000;
+    static constexpr int FRAME_SIZE = 400;
+    static constexpr int FRAME_STEP = 160;
+    static constexpr int N_FFT = FRAME_SIZE / 2 + 1;
+    static constexpr int PAD = FRAME_SIZE / 2;  // Reflect padding before the first sample
+    static constexpr int TRAILING_PAD_SECONDS = 30;
+
+    void buildFilters();
+    float sampleAt(long long index) const;
+    void computeFrame(long long frame);
+    bool frameReady(long long frame) const;
+
+    int nMel;
+    std::vector<float> filters;   // nMel x N_FFT
+    std::vector<float> cosTable;  // N_FFT x FRAME_SIZE, Hann window folded in
+    std::vector<float> sinTable;
+
+    std::vector<float> head;      // First PAD + 1 samples, for the reflect padding
+    std::vector<float> window;    // Samples from windowStart onwards
+    long long windowStart;
+    long long totalSamples;
+    long long nextFrame;
+    bool finishing;
+
+    std::vector<float> frames;    // Frame-major log10 mel energies
+    std::vector<float> frameScratch;
+    std::vector<float> powerScratch;
+    float maxValue;
+};
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,111 @@
+#include "audio/model_governor.hpp"
+#include "audio/model_manager.hpp"
+#include <QtCore/QDebug>
+#include <numeric>
+
+namespace whisper_client {
+namespace audio {
+
+ModelGovernor::ModelGovernor(ModelManager* modelManager, QObject* parent)
+    : QObject(parent)
+    , modelManager(modelManager)
+    , enabled(false)
+{
+}
+
+void ModelGovernor::setEnabled(bool enable) {
+    enabled = enable;
+    samples.clear();
+    if (enabled && ceilingModel.isEmpty()) {
+        ceilingModel = modelManager->getCurrentModel();
+    }
+}
+
+double ModelGovernor::averageRealTimeFactor() const {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+}
+
+void ModelGovernor::recordUtterance(double audioSeconds, double decodeSeconds) {
+    if (audioSeconds < MIN_AUDIO_SECONDS) {
+        return;
+    }
+
+    samples.push_back(decodeSeconds / audioSeconds);
+    if (samples.size() > WINDOW) {
+        samples.pop_front();
+    }
+
+    const QString current = modelManager->getCurrentModel();
+    const double rtf = averageRealTimeFactor();
+    emit realTimeFactorChanged(current, rtf);
+
+    // Decide only on a full window; it is cleared after every step, which
+    // doubles as the cool-down while the new model loads and settles
+    if (!enabled || samples.size() < WINDOW) {
+        return;
+    }
+
+    const int tier = tierOf(current);
+    if (tier < 0) {
+        return;  // Not a model the governor knows how to rank
+    }
+
+    QString target;
+    if (rtf > STEP_DOWN_RTF) {
+        target = nextAvailableTier(tier, -1);
+    } else if (rtf < STEP_UP_RTF && tier < tierOf(ceilingModel)) {
+        target = nextAvailableTier(tier, 1);
+        if (tierOf(target) > tierOf(ceilingModel)) {
+            target.clear();
+        }
+    }
+
+    if (target.isEmpty() || !modelManager->setModel(target)) {
+        return;
+    }
+
+    qDebug() << "Model governor:" << current << "->" << target << "at RTF" << rtf;
+    samples.clear();
+    steppedFrom = current;
+    steppedTo = target;
+    emit modelStepped(current, target, rtf);
+}
+
+void ModelGovernor::modelLoadFailed(const QString& modelPath) {
+    // Only undo our own step, and only while it is still the current model
+    const QString current = modelManager->getCurrentModel();
+    if (steppedTo.isEmpty() || current != steppedTo || modelPath != modelManager->getModelPath(current)) {
+        return;
+    }
+
+    qWarning() << "Model governor: failed to load" << steppedTo << "- returning to" << steppedFrom;
+    const QString failed = steppedTo;
+    const QString restored = steppedFrom;
+    unloadable.append(failed);
+    steppedFrom.clear();
+    steppedTo.clear();
+    samples.clear();
+    if (modelManager->setModel(restored)) {
+        emit stepReverted(failed, restored);
+    }
+}
+
+int ModelGovernor::tierOf(const QString& modelName) const {
+    return TIERS.indexOf(modelName);
+}
+
+QString ModelGovernor::nextAvailableTier(int from, int step) const {
+    // Only tiers that are downloaded and verified; the governor never starts a download
+    for (int i = from + step; i >= 0 && i < TIERS.size(); i += step) {
+        if (!unloadable.contains(TIERS[i]) && modelManager->isModelAvailable(TIERS[i])) {
+            return TIERS[i];
+        }
+    }
+    return QString();
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <deque>
+
+namespace whisper_client {
+namespace audio {
+
+class ModelManager;
+
+// Keeps transcription ahead of real time by moving between model tiers.
+// Every decoded utterance reports its real-time factor (decode time divided
+// by audio length); when the rolling average stays too high the governor
+// steps down one downloaded tier, and when it stays low it steps back up,
+// never above the model that was current when the governor was enabled.
+// A step whose model fails to load is rolled back and that model is not
+// tried again.
+class ModelGovernor : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ModelGovernor(ModelManager* modelManager, QObject* parent = nullptr);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    double averageRealTimeFactor() const;
+
+    // Rolling real-time factor above which the governor steps down, and below
+    // which it steps back up
+    static constexpr double STEP_DOWN_RTF = 0.8;
+    static constexpr double STEP_UP_RTF = 0.3;        // Well below STEP_DOWN_RTF to avoid flapping
+
+public slots:
+    void recordUtterance(double audioSeconds, double decodeSeconds);
+    void modelLoadFailed(const QString& modelPath);
+
+signals:
+    void realTimeFactorChanged(const QString& modelName, double realTimeFactor);
+    void modelStepped(const QString& fromModel, const QString& toModel, double realTimeFactor);
+    void stepReverted(const QString& failedModel, const QString& restoredModel);
+
+private:
+    int tierOf(const QString& modelName) const;
+    QString nextAvailableTier(int from, int step) const;
+
+    ModelManager* modelManager;
+    bool enabled;
+    QString ceilingModel;
+    QString steppedFrom;          // Model before the last step, for rollback
+    QString steppedTo;
+    QStringList unloadable;       // Models that failed to load after a step
+    std::deque<double> samples;   // Recent real-time factors, newest last
+
+    // Fastest first. Quantized variants sit just below the f16 model they
+    // were made from.
+    const QStringList TIERS = {
+        "tiny-q5_1", "tiny-q8_0", "tiny",
+        "base-q5_1", "base-q8_0", "base",
+        "small-q5_1", "small-q8_0", "small",
+        "medium-q5_0", "medium-q8_0", "medium",
+        "large-v3-q5_0", "large"
+    };
+
+    static constexpr size_t WINDOW = 4;               // Utterances per decision
+    static constexpr double MIN_AUDIO_SECONDS = 1.0;  // Fixed overhead dominates below this
+};
+
+} // namespace audio
+} // namespace whisper_client
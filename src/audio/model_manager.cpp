@@ -1,23 +1,135 @@
 #include "audio/model_manager.hpp"
+#include "network/segmented_download.hpp"
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QCoreApplication>
 #include <QtNetwork/QNetworkReply>
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSaveFile>
+#include <algorithm>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
 
 namespace whisper_client {
 namespace audio {
 
+namespace {
+
+// What identifies a file's contents without reading it. A rewrite or
+// replacement changes at least one of these.
+struct FileIdentity {
+    qint64 size = -1;
+    qint64 mtime = 0;
+    QString inode;
+};
+
+FileIdentity fileIdentity(const QString& path) {
+    FileIdentity identity;
+    QFileInfo info(path);
+    if (!info.exists()) {
+        return identity;
+    }
+    identity.size = info.size();
+    identity.mtime = info.lastModified().toMSecsSinceEpoch();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(reinterpret_cast<LPCWSTR>(path.utf16()), 0,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        BY_HANDLE_FILE_INFORMATION byHandle;
+        if (GetFileInformationByHandle(file, &byHandle)) {
+            identity.inode = QString("%1:%2:%3")
+                .arg(byHandle.dwVolumeSerialNumber)
+                .arg(byHandle.nFileIndexHigh)
+                .arg(byHandle.nFileIndexLow);
+        }
+        CloseHandle(file);
+    }
+#else
+    struct stat st;
+    if (stat(QFile::encodeName(path).constData(), &st) == 0) {
+        identity.inode = QString("%1:%2").arg(st.st_dev).arg(st.st_ino);
+    }
+#endif
+    return identity;
+}
+
+// Parses "bytes <first>-<last>/<total>" or "bytes */<total>". total is -1
+// when the server sends "*".
+bool parseContentRange(const QByteArray& value, qint64* first, qint64* total) {
+    const QByteArray trimmed = value.trimmed();
+    if (!trimmed.startsWith("bytes ")) {
+        return false;
+    }
+    const QList<QByteArray> parts = trimmed.mid(6).split('/');
+    if (parts.size() != 2) {
+        return false;
+    }
+
+    bool ok = true;
+    *total = parts[1] == "*" ? -1 : parts[1].toLongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    if (parts[0] == "*") {
+        *first = -1;
+        return true;
+    }
+    *first = parts[0].split('-').value(0).toLongLong(&ok);
+    return ok;
+}
+
+} // namespace
+
 ModelManager::ModelManager(QObject* parent)
     : QObject(parent)
     , networkManager(std::make_unique<QNetworkAccessManager>())
     , currentDownload(nullptr)
+    , segmentedDownload(std::make_unique<network::SegmentedDownload>(networkManager.get()))
+    , downloadSegments(DEFAULT_DOWNLOAD_SEGMENTS)
+    , resumeOffset(0)
+    , expectedTotal(0)
+    , digestLookup(nullptr)
+    , publishedSize(0)
+    , statusChecked(false)
+    , bodyAccepted(false)
+    , resumeHashCancelled(false)
+    , preparingResume(false)
+    , downloadGeneration(0)
+    , verifyCancelled(false)
+    , verifyRunning(false)
 {
     // Set up model directory
-    QString appDir = QCoreApplication::applicationDirPath();
-    modelDir = appDir + "/models";
-    createModelDirectory();
+    setModelDirectory(QCoreApplication::applicationDirPath() + "/models");
+
+    // Segmented downloads report through the same signals as single-stream ones
+    connect(segmentedDownload.get(), &network::SegmentedDownload::progress,
+            this, &ModelManager::downloadProgress);
+    connect(segmentedDownload.get(), &network::SegmentedDownload::rangesUnsupported,
+            this, [this]() {
+                qDebug() << "Server does not support ranges, falling back to a single stream";
+                startStreamingDownload();
+            });
+    connect(segmentedDownload.get(), &network::SegmentedDownload::finished,
+            this, [this](bool success, const QString& sha256, const QString& errorMessage) {
+                const QString partPath = getModelPath(downloadModelName) + ".part";
+                if (success) {
+                    completeDownload(partPath, sha256, segmentedDownload->totalSize());
+                } else {
+                    QFile::remove(partPath);
+                    emit downloadComplete(false, errorMessage);
+                }
+            });
     
     // Initialize model information
     initializeModelInfo();
@@ -28,6 +140,11 @@ ModelManager::ModelManager(QObject* parent)
 
 ModelManager::~ModelManager() {
     cancelDownload();
+    stopResumeHash();
+    verifyCancelled = true;
+    if (verifyThread.joinable()) {
+        verifyThread.join();
+    }
 }
 
 void ModelManager::initializeModelInfo() {
@@ -59,6 +176,25 @@ void ModelManager::initializeModelInfo() {
             "0f4c8e34f21cf1a914c59d8b3ce882345ad349d86b9ecd5646f579659c661257"
         }}
     };
+
+    // Quantized variants published alongside the f16 models. Much smaller
+    // and faster on CPU-only machines. Their sizes and hashes are not pinned
+    // here; downloads are checked against the digest the host publishes for
+    // the file instead, see lookUpPublishedDigest.
+    const QStringList quantizedModels = {
+        "tiny-q5_1", "tiny-q8_0",
+        "base-q5_1", "base-q8_0",
+        "small-q5_1", "small-q8_0",
+        "medium-q5_0", "medium-q8_0",
+        "large-v3-q5_0"
+    };
+    for (const QString& name : quantizedModels) {
+        modelInfos.insert(name, {
+            QString("https://huggingface.co/ggerganov/whisper.cpp/resolve/main/ggml-%1.bin").arg(name),
+            0,
+            QString()
+        });
+    }
 }
 
 void ModelManager::createModelDirectory() {
@@ -73,6 +209,10 @@ bool ModelManager::isModelAvailable() const {
     return verifyModelFile(getModelPath(currentModelName));
 }
 
+bool ModelManager::isModelAvailable(const QString& modelName) const {
+    return verifyModelFile(modelName, getModelPath(modelName), false);
+}
+
 QString ModelManager::getModelPath() const {
     return getModelPath(currentModelName);
 }
@@ -86,7 +226,7 @@ QStringList ModelManager::getAvailableModels() const {
 }
 
 bool ModelManager::setModel(const QString& modelName) {
-    if (!AVAILABLE_MODELS.contains(modelName)) {
+    if (!modelInfos.contains(modelName)) {
         qWarning() << "Invalid model name:" << modelName;
         return false;
     }
@@ -97,85 +237,378 @@ bool ModelManager::setModel(const QString& modelName) {
 }
 
 void ModelManager::downloadModel(const QString& modelName) {
-    if (!AVAILABLE_MODELS.contains(modelName)) {
+    if (!modelInfos.contains(modelName)) {
         emit downloadComplete(false, "Invalid model name");
         return;
     }
 
-    if (currentDownload) {
+    if (currentDownload || digestLookup || preparingResume || segmentedDownload->isRunning()) {
         emit downloadComplete(false, "Download already in progress");
         return;
     }
 
+    downloadModelName = modelName;
+    publishedHash.clear();
+    publishedSize = 0;
+    if (modelInfos.value(modelName).hash.isEmpty()) {
+        lookUpPublishedDigest();
+        return;
+    }
+    startDownload();
+}
+
+void ModelManager::lookUpPublishedDigest() {
+    // Hugging Face answers a resolve URL with a redirect to its CDN that
+    // carries the file's LFS object id (its SHA-256) and size. Redirects are
+    // not followed so those headers are the ones read.
+    QNetworkRequest request(getModelUrl(downloadModelName));
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    request.setTransferTimeout(DIGEST_LOOKUP_TIMEOUT_MS);
+    digestLookup = networkManager->head(request);
+
+    connect(digestLookup, &QNetworkReply::finished, this, [this]() {
+        QNetworkReply* reply = digestLookup;
+        digestLookup = nullptr;
+        reply->deleteLater();
+
+        QByteArray hash = reply->rawHeader("X-Linked-ETag").trimmed();
+        if (hash.startsWith("W/")) {
+            hash = hash.mid(2);
+        }
+        hash = hash.replace('"', "").toLower();
+        if (hash.size() == 64 && QByteArray::fromHex(hash).toHex() == hash) {
+            publishedHash = QString::fromLatin1(hash);
+            publishedSize = std::max<qint64>(reply->rawHeader("X-Linked-Size").toLongLong(), 0);
+            qDebug() << "Published digest of" << downloadModelName << ":" << publishedHash;
+        } else {
+            qDebug() << "No published digest for" << downloadModelName << "- checking size only";
+        }
+        startDownload();
+    });
+}
+
+void ModelManager::startDownload() {
+    // Fresh downloads fetch several ranges in parallel; an interrupted
+    // single-stream download is resumed where it left off instead
+    const QString partPath = getModelPath(downloadModelName) + ".part";
+    if (downloadSegments > 1 && !QFile::exists(partPath)) {
+        qDebug() << "Starting segmented download of model:" << downloadModelName;
+        segmentedDownload->start(QUrl(getModelUrl(downloadModelName)), partPath, downloadSegments);
+        return;
+    }
+    startStreamingDownload();
+}
+
+void ModelManager::setDownloadSegments(int segments) {
+    downloadSegments = std::max(1, segments);
+}
+
+void ModelManager::addModel(const QString& modelName, const QString& url, qint64 size, const QString& sha256) {
+    modelInfos.insert(modelName, {url, size, sha256.toLower()});
+}
+
+void ModelManager::setModelDirectory(const QString& directory) {
+    modelDir = directory;
+    createModelDirectory();
+    manifestPath = modelDir + "/manifest.json";
+    loadManifest();
+}
+
+void ModelManager::startStreamingDownload() {
+    // Body goes straight to <model>.part; a .part left by an interrupted
+    // download is resumed with a Range request
+    const QString partPath = getModelPath(downloadModelName) + ".part";
+    const qint64 existing = QFileInfo(partPath).size();
+    downloadHash = std::make_unique<QCryptographicHash>(QCryptographicHash::Sha256);
+    if (existing <= 0) {
+        beginStreamingRequest(0);
+        return;
+    }
+
+    // The hash must cover the bytes already on disk before new ones arrive.
+    // That can be gigabytes, so it is read on a background thread.
+    stopResumeHash();
+    preparingResume = true;
+    resumeHashCancelled = false;
+    const unsigned int generation = downloadGeneration;
+    resumeHashThread = std::thread([this, partPath, existing, generation]() {
+        qint64 hashed = 0;
+        QFile file(partPath);
+        if (file.open(QIODevice::ReadOnly)) {
+            QByteArray chunk(4 * 1024 * 1024, Qt::Uninitialized);
+            while (hashed < existing && !resumeHashCancelled) {
+                const qint64 n = file.read(chunk.data(), std::min<qint64>(chunk.size(), existing - hashed));
+                if (n <= 0) {
+                    break;
+                }
+                downloadHash->addData(QByteArrayView(chunk.constData(), n));
+                hashed += n;
+            }
+        }
+
+        const bool complete = (hashed == existing);
+        QMetaObject::invokeMethod(this, [this, existing, complete, generation]() {
+            if (generation != downloadGeneration) {
+                return;  // Cancelled while hashing
+            }
+            preparingResume = false;
+            if (!complete) {
+                // Leave the .part alone; it may still be resumable later
+                downloadHash.reset();
+                emit downloadComplete(false, "Failed to read partial model file");
+                return;
+            }
+            beginStreamingRequest(existing);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ModelManager::beginStreamingRequest(qint64 offset) {
+    const QString modelName = downloadModelName;
+
+    partFile = std::make_unique<QFile>(getModelPath(modelName) + ".part");
+    if (!partFile->open(QIODevice::ReadWrite) || !partFile->seek(offset)) {
+        closePartFile();
+        emit downloadComplete(false, "Failed to open model file for writing");
+        return;
+    }
+    resumeOffset = offset;
+    expectedTotal = 0;
+    statusChecked = false;
+    bodyAccepted = false;
+
     QString url = getModelUrl(modelName);
     QNetworkRequest request(url);
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, 
                         QNetworkRequest::NoLessSafeRedirectPolicy);
+    if (resumeOffset > 0) {
+        request.setRawHeader("Range", QByteArray("bytes=") + QByteArray::number(resumeOffset) + "-");
+    }
 
     currentDownload = networkManager->get(request);
 
+    connect(currentDownload, &QNetworkReply::readyRead,
+            this, &ModelManager::onDownloadReadyRead);
     connect(currentDownload, &QNetworkReply::downloadProgress,
             this, &ModelManager::onDownloadProgress);
     connect(currentDownload, &QNetworkReply::finished,
             this, &ModelManager::onDownloadFinished);
-    connect(currentDownload, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error),
+    connect(currentDownload, &QNetworkReply::errorOccurred,
             this, &ModelManager::onDownloadError);
 
-    qDebug() << "Starting download of model:" << modelName;
+    qDebug() << "Starting download of model:" << modelName
+             << (resumeOffset > 0 ? QString("resuming at %1 bytes").arg(resumeOffset) : QString());
 }
 
 void ModelManager::cancelDownload() {
+    ++downloadGeneration;
+    if (digestLookup) {
+        QNetworkReply* reply = digestLookup;
+        digestLookup = nullptr;
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+        qDebug() << "Download cancelled";
+    }
+    if (preparingResume) {
+        stopResumeHash();
+        preparingResume = false;
+        downloadHash.reset();
+        qDebug() << "Download cancelled";
+    }
+    if (segmentedDownload && segmentedDownload->isRunning()) {
+        // A segmented .part has holes and cannot be resumed
+        segmentedDownload->abort();
+        QFile::remove(getModelPath(downloadModelName) + ".part");
+        qDebug() << "Download cancelled";
+    }
     if (currentDownload) {
-        currentDownload->abort();
-        currentDownload->deleteLater();
-        currentDownload = nullptr;
+        releaseDownload();  // .part is kept for resume
         qDebug() << "Download cancelled";
     }
 }
 
+void ModelManager::stopResumeHash() {
+    resumeHashCancelled = true;
+    if (resumeHashThread.joinable()) {
+        resumeHashThread.join();
+    }
+}
+
+void ModelManager::onDownloadReadyRead() {
+    if (!currentDownload || !partFile) return;
+
+    if (!statusChecked && !acceptResponse()) {
+        return;
+    }
+    if (!bodyAccepted) {
+        return;
+    }
+
+    const QByteArray chunk = currentDownload->readAll();
+    if (partFile->write(chunk) != chunk.size()) {
+        failDownload("Failed to write model data: " + partFile->errorString());
+        return;
+    }
+    downloadHash->addData(chunk);
+}
+
+bool ModelManager::acceptResponse() {
+    const int status = currentDownload->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 0) {
+        return false;  // No response yet; network errors are reported by onDownloadError
+    }
+    statusChecked = true;
+
+    // Only the model itself may reach the .part: a full body for a fresh
+    // download, or the continuation of the bytes already on disk
+    qint64 first = 0;
+    qint64 total = 0;
+    const QByteArray contentRange = currentDownload->rawHeader("Content-Range");
+    if (status == 200) {
+        if (resumeOffset > 0) {
+            // A server that ignores Range sends the whole file again
+            qDebug() << "Server did not honour the range request, restarting download";
+            if (!partFile->resize(0) || !partFile->seek(0)) {
+                failDownload("Failed to restart model download");
+                return false;
+            }
+            resumeOffset = 0;
+            downloadHash->reset();
+        }
+        expectedTotal = currentDownload->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+        bodyAccepted = true;
+        return true;
+    }
+    if (status == 206 && resumeOffset > 0 && parseContentRange(contentRange, &first, &total) &&
+        first == resumeOffset) {
+        expectedTotal = std::max<qint64>(total, 0);
+        bodyAccepted = true;
+        return true;
+    }
+    if (status == 416 && resumeOffset > 0 && parseContentRange(contentRange, &first, &total) &&
+        total == resumeOffset) {
+        // The .part already holds the whole file
+        const QString fileHash = downloadHash->result().toHex();
+        const QString partPath = partFile->fileName();
+        expectedTotal = total;
+        releaseDownload();
+        completeDownload(partPath, fileHash, total);
+        return false;
+    }
+
+    failDownload(QString("Server returned HTTP %1").arg(status));
+    return false;
+}
+
 void ModelManager::onDownloadProgress(qint64 bytesReceived, qint64 bytesTotal) {
-    emit downloadProgress(bytesReceived, bytesTotal);
+    emit downloadProgress(resumeOffset + bytesReceived, bytesTotal > 0 ? resumeOffset + bytesTotal : bytesTotal);
 }
 
 void ModelManager::onDownloadFinished() {
     if (!currentDownload) return;
 
-    if (currentDownload->error() == QNetworkReply::NoError) {
-        QString modelPath = getModelPath(currentModelName);
-        QFile file(modelPath);
-        
-        if (file.open(QIODevice::WriteOnly)) {
-            file.write(currentDownload->readAll());
-            file.close();
-
-            // Verify the downloaded file
-            if (verifyModelFile(modelPath)) {
-                emit downloadComplete(true, "Download completed successfully");
-            } else {
-                file.remove();
-                emit downloadComplete(false, "Model verification failed");
-            }
-        } else {
-            emit downloadComplete(false, "Failed to save model file");
-        }
+    if (currentDownload->error() != QNetworkReply::NoError) {
+        return;  // Handled by onDownloadError
     }
 
-    currentDownload->deleteLater();
-    currentDownload = nullptr;
+    onDownloadReadyRead();  // Status check and anything still buffered
+    if (!currentDownload) {
+        return;  // Rejected or already completed
+    }
+
+    const QString fileHash = downloadHash->result().toHex();
+    const QString partPath = partFile->fileName();
+    const qint64 expectedSize = expectedTotal;
+    releaseDownload();
+    completeDownload(partPath, fileHash, expectedSize);
 }
 
 void ModelManager::onDownloadError(QNetworkReply::NetworkError error) {
-    QString errorMessage = currentDownload ? currentDownload->errorString() 
-                                         : "Unknown error";
+    (void)error;
+    if (!currentDownload) return;
+
+    const QString errorMessage = currentDownload->errorString();
+
+    // Keep model bytes that arrived before the failure so the next attempt
+    // can resume; an error page is never accepted as body
+    onDownloadReadyRead();
+    if (!currentDownload) {
+        return;  // Rejected and reported already
+    }
+    releaseDownload();
     emit downloadComplete(false, errorMessage);
-    
+}
+
+void ModelManager::completeDownload(const QString& partPath, const QString& fileHash, qint64 expectedSize) {
+    const QString modelPath = getModelPath(downloadModelName);
+    const ModelInfo info = modelInfos.value(downloadModelName);
+    const QString pinnedHash = info.hash.isEmpty() ? publishedHash : info.hash;
+    const qint64 pinnedSize = info.size > 0 ? info.size : publishedSize;
+    const qint64 fileSize = QFileInfo(partPath).size();
+
+    // Also held to the length the server announced. A connection that
+    // closed early leaves a short .part, which is kept so the next attempt
+    // resumes.
+    if (expectedSize > 0 && fileSize < expectedSize) {
+        emit downloadComplete(false, QString("Download incomplete: received %1 of %2 bytes")
+                                         .arg(fileSize).arg(expectedSize));
+        return;
+    }
+
+    // Verified from the hash computed while downloading, no second pass
+    if ((expectedSize > 0 && fileSize != expectedSize) ||
+        (pinnedSize > 0 && fileSize != pinnedSize) ||
+        (!pinnedHash.isEmpty() && fileHash != pinnedHash)) {
+        QFile::remove(partPath);
+        emit downloadComplete(false, "Model verification failed");
+        return;
+    }
+
+    QFile::remove(modelPath);
+    {
+        // Nothing recorded for the file being replaced carries over
+        std::lock_guard<std::mutex> lock(manifestMutex);
+        manifest.remove(QFileInfo(modelPath).absoluteFilePath());
+    }
+    if (QFile::rename(partPath, modelPath)) {
+        recordManifestEntry(modelPath, fileHash, info.hash.isEmpty() ? publishedHash : QString());
+        emit downloadComplete(true, "Download completed successfully");
+    } else {
+        emit downloadComplete(false, "Failed to save model file");
+    }
+}
+
+void ModelManager::failDownload(const QString& message) {
+    qWarning() << "Model download failed:" << message;
+    releaseDownload();
+    emit downloadComplete(false, message);
+}
+
+void ModelManager::releaseDownload() {
     if (currentDownload) {
+        currentDownload->disconnect(this);
+        currentDownload->abort();
         currentDownload->deleteLater();
         currentDownload = nullptr;
     }
+    closePartFile();
+}
+
+void ModelManager::closePartFile() {
+    if (partFile) {
+        partFile->close();
+        partFile.reset();
+    }
+    downloadHash.reset();
 }
 
 QString ModelManager::getModelUrl(const QString& modelName) const {
+    // Overridable, e.g. to point at a local mirror or a test server
+    const QString baseUrl = qEnvironmentVariable("WHISPER_CLIENT_MODEL_BASE_URL");
+    if (!baseUrl.isEmpty()) {
+        return QString("%1/ggml-%2.bin").arg(baseUrl.endsWith('/') ? baseUrl.chopped(1) : baseUrl, modelName);
+    }
     return modelInfos.value(modelName).url;
 }
 
@@ -184,33 +617,155 @@ QString ModelManager::getModelPath(const QString& modelName) const {
 }
 
 bool ModelManager::verifyModelFile(const QString& modelPath) const {
-    QFile file(modelPath);
-    if (!file.exists()) return false;
+    return verifyModelFile(currentModelName, modelPath, false);
+}
+
+bool ModelManager::verifyModelFile(const QString& modelName, const QString& modelPath, bool force) const {
+    const FileIdentity identity = fileIdentity(modelPath);
+    if (identity.size < 0) return false;
     
     // Verify file size
-    qint64 expectedSize = modelInfos.value(currentModelName).size;
-    if (file.size() != expectedSize) {
+    qint64 expectedSize = modelInfos.value(modelName).size;
+    if (expectedSize > 0 && identity.size != expectedSize) {
         qWarning() << "Model file size mismatch. Expected:" << expectedSize 
-                   << "Got:" << file.size();
+                   << "Got:" << identity.size;
         return false;
     }
 
-    // Optionally verify hash
-    if (file.open(QIODevice::ReadOnly)) {
-        QCryptographicHash hash(QCryptographicHash::Sha256);
-        if (hash.addData(&file)) {
-            QString fileHash = hash.result().toHex();
-            QString expectedHash = modelInfos.value(currentModelName).hash;
-            if (fileHash != expectedHash) {
-                qWarning() << "Model file hash mismatch";
-                return false;
-            }
+    // Without a pinned hash, hold the file to the digest it was downloaded against
+    const QString key = QFileInfo(modelPath).absoluteFilePath();
+    QString expectedHash = modelInfos.value(modelName).hash;
+    if (expectedHash.isEmpty()) {
+        std::lock_guard<std::mutex> lock(manifestMutex);
+        expectedHash = manifest.value(key).toObject().value("published").toString();
+    }
+    if (expectedHash.isEmpty()) {
+        return true;
+    }
+
+    // Reuse the recorded hash while the file is provably unchanged
+    QString fileHash;
+    if (!force) {
+        std::lock_guard<std::mutex> lock(manifestMutex);
+        const QJsonObject entry = manifest.value(key).toObject();
+        if (entry.value("size").toVariant().toLongLong() == identity.size &&
+            entry.value("mtime").toVariant().toLongLong() == identity.mtime &&
+            entry.value("inode").toString() == identity.inode) {
+            fileHash = entry.value("sha256").toString();
         }
-        file.close();
     }
 
+    if (fileHash.isEmpty()) {
+        fileHash = hashFile(modelPath);
+        if (fileHash.isEmpty()) {
+            return false;  // Unreadable or cancelled
+        }
+
+        recordManifestEntry(modelPath, fileHash);
+    }
+
+    if (fileHash != expectedHash) {
+        qWarning() << "Model file hash mismatch";
+        return false;
+    }
     return true;
 }
 
+QString ModelManager::hashFile(const QString& modelPath) const {
+    QFile file(modelPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QByteArray chunk(4 * 1024 * 1024, Qt::Uninitialized);
+    while (!file.atEnd()) {
+        if (verifyCancelled) {
+            return QString();
+        }
+        const qint64 n = file.read(chunk.data(), chunk.size());
+        if (n < 0) {
+            return QString();
+        }
+        hash.addData(QByteArrayView(chunk.constData(), n));
+    }
+    return hash.result().toHex();
+}
+
+void ModelManager::reverifyModel(const QString& modelName) {
+    // At most one background verification at a time
+    if (verifyRunning) {
+        qDebug() << "Model verification already in progress";
+        return;
+    }
+    if (verifyThread.joinable()) {
+        verifyThread.join();  // Finished already
+    }
+
+    verifyCancelled = false;
+    verifyRunning = true;
+    const QString modelPath = getModelPath(modelName);
+    verifyThread = std::thread([this, modelName, modelPath]() {
+        const bool valid = verifyModelFile(modelName, modelPath, true);
+        if (!verifyCancelled) {
+            emit verificationFinished(modelName, valid);
+        }
+        verifyRunning = false;
+    });
+}
+
+void ModelManager::recordManifestEntry(const QString& modelPath, const QString& sha256,
+                                       const QString& publishedSha256) const {
+    const FileIdentity identity = fileIdentity(modelPath);
+    if (identity.size < 0) {
+        return;
+    }
+
+    QJsonObject entry;
+    entry["size"] = QString::number(identity.size);
+    entry["mtime"] = QString::number(identity.mtime);
+    entry["inode"] = identity.inode;
+    entry["sha256"] = sha256;
+    {
+        // A rehash keeps the digest the file was downloaded against
+        std::lock_guard<std::mutex> lock(manifestMutex);
+        const QString key = QFileInfo(modelPath).absoluteFilePath();
+        const QString published = publishedSha256.isEmpty()
+            ? manifest.value(key).toObject().value("published").toString()
+            : publishedSha256;
+        if (!published.isEmpty()) {
+            entry["published"] = published;
+        }
+        manifest[key] = entry;
+    }
+    saveManifest();
+}
+
+void ModelManager::loadManifest() {
+    QJsonObject loaded;
+    QFile file(manifestPath);
+    if (file.open(QIODevice::ReadOnly)) {
+        loaded = QJsonDocument::fromJson(file.readAll()).object();
+    }
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    manifest = loaded;
+}
+
+void ModelManager::saveManifest() const {
+    QJsonObject snapshot;
+    {
+        std::lock_guard<std::mutex> lock(manifestMutex);
+        snapshot = manifest;
+    }
+
+    QSaveFile file(manifestPath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(snapshot).toJson());
+        if (!file.commit()) {
+            qWarning() << "Failed to write model manifest:" << manifestPath;
+        }
+    }
+}
+
 } // namespace audio
 } // namespace whisper_client
\ No newline at end of file
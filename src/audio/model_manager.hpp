@@ -7,9 +7,20 @@
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
+#include <QtCore/QJsonObject>
+#include <QtCore/QFile>
+#include <QtCore/QCryptographicHash>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
 
 namespace whisper_client {
+
+namespace network {
+class SegmentedDownload;
+}
+
 namespace audio {
 
 class ModelManager : public QObject {
@@ -21,23 +32,41 @@ public:
 
     // Model management
     bool isModelAvailable() const;
+    bool isModelAvailable(const QString& modelName) const;  // Present and passes size and hash checks
     QString getModelPath() const;
+    QString getModelPath(const QString& modelName) const;
     QString getCurrentModel() const;
     
     // Available models
     QStringList getAvailableModels() const;
     bool setModel(const QString& modelName);
 
+    // Parallel byte ranges for fresh downloads; 1 disables segmenting
+    void setDownloadSegments(int segments);
+
+    // Where models and the manifest live; defaults to <app dir>/models
+    void setModelDirectory(const QString& directory);
+
+    // Adds or replaces a catalogue entry, e.g. a model on a private mirror.
+    // A size of 0 or an empty hash leaves that check to the published digest.
+    void addModel(const QString& modelName, const QString& url, qint64 size, const QString& sha256);
+
 public slots:
     void downloadModel(const QString& modelName);
     void cancelDownload();
 
+    // Rehashes the model file on a background thread, ignoring the cached
+    // manifest entry, and reports through verificationFinished
+    void reverifyModel(const QString& modelName);
+
 signals:
     void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
     void downloadComplete(bool success, const QString& message);
     void modelChanged(const QString& modelName);
+    void verificationFinished(const QString& modelName, bool valid);
 
 private slots:
+    void onDownloadReadyRead();
     void onDownloadProgress(qint64 bytesReceived, qint64 bytesTotal);
     void onDownloadFinished();
     void onDownloadError(QNetworkReply::NetworkError error);
@@ -45,26 +74,85 @@ private slots:
 private:
     void initializeModelInfo();
     QString getModelUrl(const QString& modelName) const;
-    QString getModelPath(const QString& modelName) const;
     bool verifyModelFile(const QString& modelPath) const;
+    bool verifyModelFile(const QString& modelName, const QString& modelPath, bool force) const;
+    QString hashFile(const QString& modelPath) const;
+    void recordManifestEntry(const QString& modelPath, const QString& sha256,
+                             const QString& publishedSha256 = QString()) const;
+    void lookUpPublishedDigest();
+    void startDownload();
+    void startStreamingDownload();
+    void beginStreamingRequest(qint64 offset);
+    bool acceptResponse();
+    void completeDownload(const QString& partPath, const QString& fileHash, qint64 expectedSize);
+    void failDownload(const QString& message);
+    void releaseDownload();
+    void stopResumeHash();
+    void closePartFile();
+    void loadManifest();
+    void saveManifest() const;
     void createModelDirectory();
 
     std::unique_ptr<QNetworkAccessManager> networkManager;
     QNetworkReply* currentDownload;
+
+    std::unique_ptr<network::SegmentedDownload> segmentedDownload;
+    int downloadSegments;
+
+    // Download in progress: body is streamed to partFile and hashed as it
+    // arrives. Nothing is written until the response status has been checked.
+    QString downloadModelName;
+    std::unique_ptr<QFile> partFile;
+    std::unique_ptr<QCryptographicHash> downloadHash;
+    qint64 resumeOffset;
+    qint64 expectedTotal;   // Full file size announced by the server, 0 if unknown
+
+    // For entries without a pinned hash: the SHA-256 and size the host
+    // publishes for the file (Hugging Face's LFS object id), looked up with a
+    // HEAD request before the download starts. Empty or 0 if not published.
+    QNetworkReply* digestLookup;
+    QString publishedHash;
+    qint64 publishedSize;
+    bool statusChecked;
+    bool bodyAccepted;
+
+    // Resuming first hashes the existing .part on this thread; downloadHash
+    // belongs to it until the continuation runs on the GUI thread
+    std::thread resumeHashThread;
+    std::atomic<bool> resumeHashCancelled;
+    bool preparingResume;
+    unsigned int downloadGeneration;  // Bumped on cancel so stale continuations are ignored
     QString modelDir;
     QString currentModelName;
     
     struct ModelInfo {
         QString url;
-        qint64 size;
-        QString hash;
+        qint64 size;    // 0 if unknown
+        QString hash;   // SHA-256, empty if unknown
     };
     QMap<QString, ModelInfo> modelInfos;
 
+    // Verification manifest: path -> {size, mtime, inode, sha256, published}.
+    // A file whose identity still matches its entry is not hashed again.
+    // "published" is the digest a download was checked against, kept so later
+    // verifications of an entry without a pinned hash still compare to it.
+    mutable std::mutex manifestMutex;
+    mutable QJsonObject manifest;
+    QString manifestPath;
+
+    std::thread verifyThread;
+    std::atomic<bool> verifyCancelled;
+    std::atomic<bool> verifyRunning;
+
     // Constants
     const QString DEFAULT_MODEL = "base";
+    static constexpr int DEFAULT_DOWNLOAD_SEGMENTS = 4;
+    static constexpr int DIGEST_LOOKUP_TIMEOUT_MS = 15000;
     const QStringList AVAILABLE_MODELS = {
-        "tiny", "base", "small", "medium", "large"
+        "tiny", "base", "small", "medium", "large",
+        "tiny-q5_1", "tiny-q8_0", "base-q5_1", "base-q8_0",
+        "small-q5_1", "small-q8_0", "medium-q5_0", "medium-q8_0",
+        "large-v3-q5_0"
     };
 };
 
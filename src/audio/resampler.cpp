@@ -0,0 +1,193 @@
+#include "audio/resampler.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WHISPER_CLIENT_RESAMPLER_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define WHISPER_CLIENT_RESAMPLER_NEON
+#endif
+
+namespace whisper_client {
+namespace audio {
+
+namespace {
+
+// Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = x / 2.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+Resampler::Resampler()
+    : channels(1)
+    , upFactor(1)
+    , downFactor(1)
+    , inputPos(0)
+    , phase(0)
+{
+}
+
+bool Resampler::configure(unsigned int inputRate, unsigned int inputChannels, unsigned int outputRate) {
+    if (inputRate == 0 || outputRate == 0 || inputChannels == 0) {
+        return false;
+    }
+
+    const unsigned int divisor = std::gcd(inputRate, outputRate);
+    const unsigned int up = outputRate / divisor;
+    const unsigned int down = inputRate / divisor;
+    if (up > MAX_PHASES) {
+        return false;
+    }
+
+    channels = inputChannels;
+    upFactor = up;
+    downFactor = down;
+    filters.clear();
+    if (upFactor != downFactor) {
+        // Cutoff relative to the input rate, below the Nyquist of the lower rate
+        buildFilters(CUTOFF * std::min(inputRate, outputRate) / inputRate);
+    }
+    reset();
+    return true;
+}
+
+void Resampler::reset() {
+    buffer.assign(TAPS_PER_PHASE - 1, 0.0f);
+    inputPos = TAPS_PER_PHASE - 1;
+    phase = 0;
+}
+
+void Resampler::buildFilters(double cutoff) {
+    // Prototype low-pass at upFactor times the input rate, split into
+    // upFactor phases. Row p holds taps p, p + L, p + 2L, ... reversed, so the
+    // dot product walks the input forwards.
+    const size_t length = static_cast<size_t>(upFactor) * TAPS_PER_PHASE;
+    const double centre = (length - 1) / 2.0;
+    const double pi = 3.14159265358979323846;
+    const double windowNorm = besselI0(KAISER_BETA);
+
+    filters.assign(length, 0.0f);
+    std::vector<double> row(TAPS_PER_PHASE);
+    for (unsigned int p = 0; p < upFactor; ++p) {
+        double sum = 0.0;
+        for (size_t k = 0; k < TAPS_PER_PHASE; ++k) {
+            const size_t j = p + static_cast<size_t>(upFactor) * k;
+            const double t = (j - centre) / upFactor;  // In input samples
+            const double x = 2.0 * cutoff * t;
+            const double sinc = std::abs(x) < 1e-12 ? 1.0 : std::sin(pi * x) / (pi * x);
+            const double r = (j - centre) / centre;
+            const double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / windowNorm;
+            row[k] = 2.0 * cutoff * sinc * window;
+            sum += row[k];
+        }
+
+        // Unity gain at DC for every phase
+        float* dest = filters.data() + static_cast<size_t>(p) * TAPS_PER_PHASE;
+        for (size_t k = 0; k < TAPS_PER_PHASE; ++k) {
+            dest[TAPS_PER_PHASE - 1 - k] = static_cast<float>(row[k] / sum);
+        }
+    }
+}
+
+void Resampler::process(const float* input, size_t frames, std::vector<float>& out) {
+    if (frames == 0) {
+        return;
+    }
+
+    if (isPassthrough()) {
+        out.insert(out.end(), input, input + frames);
+        return;
+    }
+
+    // Downmix into the filter buffer, or straight to the output at equal rates
+    const float scale = 1.0f / channels;
+    std::vector<float>& mono = (upFactor == downFactor) ? out : buffer;
+    const size_t start = mono.size();
+    mono.resize(start + frames);
+    if (channels == 1) {
+        std::copy(input, input + frames, mono.begin() + start);
+    } else if (channels == 2) {
+        for (size_t i = 0; i < frames; ++i) {
+            mono[start + i] = (input[2 * i] + input[2 * i + 1]) * scale;
+        }
+    } else {
+        for (size_t i = 0; i < frames; ++i) {
+            float sum = 0.0f;
+            for (unsigned int c = 0; c < channels; ++c) {
+                sum += input[i * channels + c];
+            }
+            mono[start + i] = sum * scale;
+        }
+    }
+    if (upFactor == downFactor) {
+        return;
+    }
+
+    // One output per downFactor steps of the upsampled timeline
+    const size_t available = buffer.size();
+    out.reserve(out.size() + (frames * upFactor) / downFactor + 1);
+    while (inputPos < available) {
+        const float* taps = filters.data() + static_cast<size_t>(phase) * TAPS_PER_PHASE;
+        out.push_back(dot(taps, buffer.data() + inputPos + 1 - TAPS_PER_PHASE, TAPS_PER_PHASE));
+
+        phase += downFactor;
+        inputPos += phase / upFactor;
+        phase %= upFactor;
+    }
+
+    // Keep only the history the next output needs
+    const size_t keepFrom = std::min(inputPos, available) + 1 - TAPS_PER_PHASE;
+    buffer.erase(buffer.begin(), buffer.begin() + keepFrom);
+    inputPos -= keepFrom;
+}
+
+float Resampler::dot(const float* a, const float* b, size_t count) {
+#if defined(WHISPER_CLIENT_RESAMPLER_SSE2)
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    for (size_t i = 0; i < count; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    sum0 = _mm_add_ps(sum0, sum1);
+    sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+    sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, 1));
+    return _mm_cvtss_f32(sum0);
+#elif defined(WHISPER_CLIENT_RESAMPLER_NEON)
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < count; i += 8) {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    sum0 = vaddq_f32(sum0, sum1);
+    float32x2_t half = vadd_f32(vget_low_f32(sum0), vget_high_f32(sum0));
+    return vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+    float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < count; i += 4) {
+        sum[0] += a[i] * b[i];
+        sum[1] += a[i + 1] * b[i + 1];
+        sum[2] += a[i + 2] * b[i + 2];
+        sum[3] += a[i + 3] * b[i + 3];
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+#endif
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace whisper_client {
+namespace audio {
+
+// Downmixes interleaved input to mono and converts it to the output rate with
+// a polyphase windowed-sinc filter. Streaming: filter state carries over
+// between process() calls, so input may arrive in blocks of any size.
+class Resampler {
+public:
+    Resampler();
+
+    // Builds the filter bank for inputRate -> outputRate. Fails for rates whose
+    // ratio needs more than MAX_PHASES filter phases.
+    bool configure(unsigned int inputRate, unsigned int inputChannels, unsigned int outputRate);
+    void reset();
+
+    // Appends the output for frames interleaved input frames to out
+    void process(const float* input, size_t frames, std::vector<float>& out);
+
+    bool isPassthrough() const { return upFactor == downFactor && channels == 1; }
+    unsigned int inputChannels() const { return channels; }
+
+private:
+    static constexpr size_t TAPS_PER_PHASE = 128;  // Filter length in input samples; multiple of 8
+    static constexpr unsigned int MAX_PHASES = 1024;
+    static constexpr double CUTOFF = 0.45;         // Fraction of the lower of the two rates
+    static constexpr double KAISER_BETA = 8.6;     // ~85 dB stopband
+
+    void buildFilters(double cutoff);
+    static float dot(const float* a, const float* b, size_t count);
+
+    unsigned int channels;
+    unsigned int upFactor;     // L: phases per input sample
+    unsigned int downFactor;   // M: upsampled steps per output sample
+    std::vector<float> filters;  // upFactor rows of TAPS_PER_PHASE, time-reversed
+
+    std::vector<float> buffer;   // Mono input; the first TAPS_PER_PHASE - 1 samples are history
+    size_t inputPos;             // Newest input sample under the filter for the next output
+    unsigned int phase;          // Filter phase for the next output
+};
+
+} // namespace audio
+} // namespace whisper_client
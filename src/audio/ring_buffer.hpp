@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+namespace whisper_client {
+namespace audio {
+
+// Single-producer/single-consumer ring buffer for trivially copyable samples.
+// Storage is allocated once up front; write() and read() never allocate or
+// lock, so the producer side is safe to call from the real-time audio thread.
+template <typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRingBuffer requires trivially copyable elements");
+
+public:
+    explicit SpscRingBuffer(size_t minCapacity)
+        : buffer(roundUpToPowerOfTwo(minCapacity))
+        , mask(buffer.size() - 1)
+        , head(0)
+        , tail(0)
+    {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side. Returns the number of elements actually written, which is
+    // less than count when the consumer has fallen behind.
+    size_t write(const T* data, size_t count) {
+        const size_t w = head.load(std::memory_order_relaxed);
+        const size_t r = tail.load(std::memory_order_acquire);
+        const size_t n = std::min(count, buffer.size() - (w - r));
+
+        copyIn(w, data, n);
+        head.store(w + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side. Returns the number of elements copied into data.
+    size_t read(T* data, size_t count) {
+        const size_t r = tail.load(std::memory_order_relaxed);
+        const size_t w = head.load(std::memory_order_acquire);
+        const size_t n = std::min(count, w - r);
+
+        copyOut(r, data, n);
+        tail.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t available() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return buffer.size();
+    }
+
+    // Drops all pending data. Only valid while the producer is stopped.
+    void reset() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void copyIn(size_t position, const T* data, size_t count) {
+        const size_t offset = position & mask;
+        const size_t first = std::min(count, buffer.size() - offset);
+        std::memcpy(buffer.data() + offset, data, first * sizeof(T));
+        std::memcpy(buffer.data(), data + first, (count - first) * sizeof(T));
+    }
+
+    void copyOut(size_t position, T* data, size_t count) const {
+        const size_t offset = position & mask;
+        const size_t first = std::min(count, buffer.size() - offset);
+        std::memcpy(data, buffer.data() + offset, first * sizeof(T));
+        std::memcpy(data + first, buffer.data(), (count - first) * sizeof(T));
+    }
+
+    std::vector<T> buffer;
+    const size_t mask;
+
+    // Keep the indices on separate cache lines so the audio thread and the
+    // drain thread do not false-share.
+    alignas(64) std::atomic<size_t> head;  // Written by the producer
+    alignas(64) std::atomic<size_t> tail;  // Written by the consumer
+};
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,194 @@
+#include "audio/sample_convert.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define WHISPER_CLIENT_CONVERT_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#define WHISPER_CLIENT_TARGET_AVX2
+#else
+#define WHISPER_CLIENT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WHISPER_CLIENT_CONVERT_SSE2
+#endif
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+// vcvtnq_s32_f32 is ARMv8 only; 32-bit NEON builds use the scalar kernels
+#include <arm_neon.h>
+#define WHISPER_CLIENT_CONVERT_NEON
+#endif
+
+namespace whisper_client {
+namespace audio {
+
+namespace {
+
+constexpr float INT16_SCALE = 32768.0f;
+
+// Bounds for scaled samples. The vector float-to-int32 conversions turn
+// out-of-range values into INT_MIN, so they are clamped first.
+constexpr float INT16_LOWEST = -32768.0f;
+constexpr float INT16_HIGHEST = 32767.0f;
+
+void int16ToFloatScalar(const int16_t* input, float* output, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = input[i] * (1.0f / INT16_SCALE);
+    }
+}
+
+void floatToInt16Scalar(const float* input, int16_t* output, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const float scaled = std::nearbyint(input[i] * INT16_SCALE);
+        output[i] = static_cast<int16_t>(std::clamp(scaled, INT16_LOWEST, INT16_HIGHEST));
+    }
+}
+
+#ifdef WHISPER_CLIENT_CONVERT_X86
+bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+WHISPER_CLIENT_TARGET_AVX2
+void int16ToFloatAvx2(const int16_t* input, float* output, size_t count) {
+    const __m256 scale = _mm256_set1_ps(1.0f / INT16_SCALE);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo)), scale));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi)), scale));
+    }
+    int16ToFloatScalar(input + i, output + i, count - i);
+}
+
+WHISPER_CLIENT_TARGET_AVX2
+inline __m256i scaleToInt32Avx2(const float* input) {
+    const __m256 scaled = _mm256_mul_ps(_mm256_loadu_ps(input), _mm256_set1_ps(INT16_SCALE));
+    return _mm256_cvtps_epi32(
+        _mm256_min_ps(_mm256_max_ps(scaled, _mm256_set1_ps(INT16_LOWEST)), _mm256_set1_ps(INT16_HIGHEST)));
+}
+
+WHISPER_CLIENT_TARGET_AVX2
+void floatToInt16Avx2(const float* input, int16_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i a = scaleToInt32Avx2(input + i);
+        const __m256i b = scaleToInt32Avx2(input + i + 8);
+        // packs works per 128-bit lane; restore sample order afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+#endif
+
+#ifdef WHISPER_CLIENT_CONVERT_SSE2
+void int16ToFloatSse2(const int16_t* input, float* output, size_t count) {
+    const __m128 scale = _mm_set1_ps(1.0f / INT16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        // Sign-extend by placing each sample in the top half and shifting down
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    int16ToFloatScalar(input + i, output + i, count - i);
+}
+
+inline __m128i scaleToInt32Sse2(const float* input) {
+    const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(input), _mm_set1_ps(INT16_SCALE));
+    return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(scaled, _mm_set1_ps(INT16_LOWEST)), _mm_set1_ps(INT16_HIGHEST)));
+}
+
+void floatToInt16Sse2(const float* input, int16_t* output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i a = scaleToInt32Sse2(input + i);
+        const __m128i b = scaleToInt32Sse2(input + i + 4);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(a, b));
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+#endif
+
+#ifdef WHISPER_CLIENT_CONVERT_NEON
+void int16ToFloatNeon(const int16_t* input, float* output, size_t count) {
+    const float32x4_t scale = vdupq_n_f32(1.0f / INT16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t v = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    int16ToFloatScalar(input + i, output + i, count - i);
+}
+
+void floatToInt16Neon(const float* input, int16_t* output, size_t count) {
+    const float32x4_t scale = vdupq_n_f32(INT16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int32x4_t a = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(input + i), scale));
+        const int32x4_t b = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(input + i + 4), scale));
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+#endif
+
+struct Kernels {
+    void (*toFloat)(const int16_t*, float*, size_t);
+    void (*toInt16)(const float*, int16_t*, size_t);
+    const char* name;
+};
+
+Kernels selectKernels() {
+#ifdef WHISPER_CLIENT_CONVERT_X86
+    if (cpuHasAvx2()) {
+        return {&int16ToFloatAvx2, &floatToInt16Avx2, "AVX2"};
+    }
+#endif
+#if defined(WHISPER_CLIENT_CONVERT_SSE2)
+    return {&int16ToFloatSse2, &floatToInt16Sse2, "SSE2"};
+#elif defined(WHISPER_CLIENT_CONVERT_NEON)
+    return {&int16ToFloatNeon, &floatToInt16Neon, "NEON"};
+#else
+    return {&int16ToFloatScalar, &floatToInt16Scalar, "scalar"};
+#endif
+}
+
+const Kernels& kernels() {
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+void int16ToFloat(const int16_t* input, float* output, size_t count) {
+    kernels().toFloat(input, output, count);
+}
+
+void floatToInt16(const float* input, int16_t* output, size_t count) {
+    kernels().toInt16(input, output, count);
+}
+
+const char* sampleConversionKernel() {
+    return kernels().name;
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace whisper_client {
+namespace audio {
+
+// Conversion between 16-bit PCM and float samples in [-1, 1). Uses AVX2 when
+// the CPU has it, else SSE2 or NEON, else plain C++. A sample converted to
+// float and back comes out unchanged; floats outside the range saturate.
+void int16ToFloat(const int16_t* input, float* output, size_t count);
+void floatToInt16(const float* input, int16_t* output, size_t count);
+
+// Name of the kernel set in use, for logging
+const char* sampleConversionKernel();
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,360 @@
+#include "audio/transcription_worker.hpp"
+#include <QtCore/QDebug>
+#include <QtCore/QStringList>
+#include <chrono>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace whisper_client {
+namespace audio {
+
+namespace {
+
+// Highest core number + 1 an affinity mask can hold on this platform
+#ifdef _WIN32
+constexpr int MAX_AFFINITY_CORES = static_cast<int>(sizeof(DWORD_PTR) * 8);
+#elif defined(__linux__)
+constexpr int MAX_AFFINITY_CORES = CPU_SETSIZE;
+#else
+constexpr int MAX_AFFINITY_CORES = 64;
+#endif
+
+} // namespace
+
+TranscriptionWorker::TranscriptionWorker(AudioProcessor* processor, QObject* parent)
+    : QObject(parent)
+    , processor(processor)
+    , partialStart(0)
+    , hasPartial(false)
+    , partialBusy(false)
+    , partialGeneration(0)
+    , stopping(false)
+    , busy(false)
+    , calibrating(false)
+    , calibrationRequested(false)
+    , busyPolicy("queue")
+{
+    qRegisterMetaType<TranscriptionResult>("whisper_client::audio::TranscriptionResult");
+
+    // The processor invokes these on the worker thread; the signals are queued
+    // to their receivers
+    processor->setProcessingStartCallback([this]() {
+        emit processingChanged(true);
+    });
+    processor->setProcessingEndCallback([this]() {
+        emit processingChanged(false);
+    });
+    processor->setSegmentCallback([this](const QString& text, double startTime, double endTime) {
+        emit segmentReady(text, startTime, endTime);
+    });
+}
+
+TranscriptionWorker::~TranscriptionWorker() {
+    stop();
+}
+
+void TranscriptionWorker::start() {
+    if (thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+    thread = std::thread(&TranscriptionWorker::run, this);
+    qDebug() << "Transcription worker started";
+}
+
+void TranscriptionWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        jobs.clear();
+        hasPartial = false;
+        partialJob = UtteranceBuffer();
+        if (busy || partialBusy || calibrating) {
+            processor->cancelTranscription();
+        }
+    }
+    condition.notify_all();
+
+    if (thread.joinable()) {
+        thread.join();
+        qDebug() << "Transcription worker stopped";
+    }
+}
+
+void TranscriptionWorker::enqueue(UtteranceBuffer utterance) {
+    if (utterance.empty()) {
+        return;
+    }
+
+    int pending;
+    int dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Neither a provisional decode nor calibration is worth delaying a final one
+        if (partialBusy || calibrating) {
+            processor->cancelTranscription();
+        }
+
+        if (busyPolicy == "drop_oldest" && busy) {
+            dropped = static_cast<int>(jobs.size());
+            jobs.clear();
+        }
+        else if (busyPolicy == "preempt") {
+            dropped = static_cast<int>(jobs.size());
+            jobs.clear();
+            if (busy) {
+                processor->cancelTranscription();
+                ++dropped;
+            }
+        }
+        jobs.push_back(std::move(utterance));
+        pending = static_cast<int>(jobs.size());
+    }
+    condition.notify_one();
+
+    if (dropped > 0) {
+        qDebug() << "Busy policy" << busyPolicy << "dropped" << dropped << "utterance(s)";
+        emit utterancesDropped(dropped);
+    }
+    emit queueSizeChanged(pending);
+}
+
+int TranscriptionWorker::pendingJobs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(jobs.size());
+}
+
+void TranscriptionWorker::setBusyPolicy(const QString& policy) {
+    if (policy == "queue" || policy == "drop_oldest" || policy == "preempt") {
+        std::lock_guard<std::mutex> lock(mutex);
+        busyPolicy = policy;
+        qDebug() << "Busy policy set to:" << policy;
+    }
+}
+
+QString TranscriptionWorker::getBusyPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return busyPolicy;
+}
+
+void TranscriptionWorker::submitPartial(UtteranceBuffer window, qint64 windowStart) {
+    if (window.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        partialJob = std::move(window);
+        partialStart = windowStart;
+        hasPartial = true;
+    }
+    condition.notify_one();
+}
+
+void TranscriptionWorker::discardPartials() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hasPartial = false;
+    partialJob = UtteranceBuffer();
+    ++partialGeneration;
+    if (partialBusy) {
+        processor->cancelTranscription();
+    }
+}
+
+void TranscriptionWorker::requestCalibration() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        calibrationRequested = true;
+    }
+    condition.notify_one();
+}
+
+bool TranscriptionWorker::setCpuAffinity(const QString& cores) {
+    bool ok = true;
+    std::vector<int> parsed = parseCoreList(cores, &ok);
+    if (!ok) {
+        qWarning() << "Invalid CPU affinity:" << cores;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    affinityCores = std::move(parsed);
+    return true;
+}
+
+std::vector<int> TranscriptionWorker::parseCoreList(const QString& cores, bool* ok) {
+    std::vector<int> result;
+    *ok = true;
+
+    const QStringList parts = cores.split(',', Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        const QStringList range = part.trimmed().split('-');
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = range.value(0).toInt(&firstOk);
+        const int last = range.size() > 1 ? range.value(1).toInt(&lastOk) : first;
+        if (range.size() == 1) {
+            lastOk = firstOk;
+        }
+        if (!firstOk || !lastOk || range.size() > 2 || first < 0 || last < first ||
+            last >= MAX_AFFINITY_CORES) {
+            *ok = false;
+            return {};
+        }
+        for (int core = first; core <= last; ++core) {
+            result.push_back(core);
+        }
+    }
+    return result;
+}
+
+void TranscriptionWorker::applyCpuAffinity() {
+    std::vector<int> cores;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cores = affinityCores;
+    }
+    if (cores.empty()) {
+        return;
+    }
+
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int core : cores) {
+        mask |= DWORD_PTR(1) << core;
+    }
+    if (!SetThreadAffinityMask(GetCurrentThread(), mask)) {
+        qWarning() << "Failed to set worker CPU affinity. Error:" << GetLastError();
+        return;
+    }
+    qDebug() << "Transcription worker pinned to" << cores.size() << "core(s)";
+#elif defined(__linux__)
+    // Threads created from here, including ggml's compute threads, inherit the mask
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int core : cores) {
+        CPU_SET(core, &set);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        qWarning() << "Failed to set worker CPU affinity";
+        return;
+    }
+    qDebug() << "Transcription worker pinned to" << cores.size() << "core(s)";
+#else
+    // macOS only offers affinity hints through thread_policy_set, which the
+    // scheduler is free to ignore
+    qWarning() << "CPU affinity is not supported on this platform, ignoring it";
+#endif
+}
+
+void TranscriptionWorker::run() {
+    // All decodes run from this one thread, so when ggml uses OpenMP (its
+    // default where available) the thread team is created once and reused by
+    // every whisper_full call
+    applyCpuAffinity();
+
+    while (true) {
+        UtteranceBuffer utterance;
+        int pending = 0;
+        bool partial = false;
+        qint64 windowStart = 0;
+        unsigned int generation = 0;
+        AudioProcessor::CancelToken token = 0;
+        bool calibrate = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() {
+                return stopping || calibrationRequested || hasPartial || !jobs.empty();
+            });
+            if (stopping) {
+                return;
+            }
+
+            // Final utterances first, then the latest partial, then calibration
+            if (!jobs.empty()) {
+                utterance = std::move(jobs.front());
+                jobs.pop_front();
+                pending = static_cast<int>(jobs.size());
+                busy = true;
+            } else if (hasPartial) {
+                utterance = std::move(partialJob);
+                windowStart = partialStart;
+                generation = partialGeneration;
+                hasPartial = false;
+                partialBusy = true;
+                partial = true;
+            } else {
+                calibrate = true;
+                calibrationRequested = false;
+                calibrating = true;
+            }
+            // Taken under the same lock as busy/partialBusy, so any cancel
+            // issued for this job from now on invalidates the token
+            token = processor->cancellationToken();
+        }
+
+        if (calibrate) {
+            const int threads = processor->calibrateThreadCount(token);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                calibrating = false;
+                if (threads == 0 && !stopping && processor->cancellationToken() != token) {
+                    calibrationRequested = true;  // Pre-empted; run again once idle
+                }
+            }
+            if (threads > 0) {
+                processor->setThreadCount(threads);
+                emit calibrationFinished(threads);
+            }
+            continue;
+        }
+
+        if (partial) {
+            const auto decodeStart = std::chrono::steady_clock::now();
+            TranscriptionResult result = processor->processPartial(utterance, token);
+            const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - decodeStart;
+            if (result.decodedSeconds > 0.0) {
+                emit utteranceDecoded(result.decodedSeconds, decodeTime.count());
+            }
+            bool current;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                partialBusy = false;
+                current = (generation == partialGeneration);
+            }
+            if (current && !result.cancelled) {
+                emit partialReady(result, windowStart);
+            }
+            continue;
+        }
+
+        emit queueSizeChanged(pending);
+
+        const auto decodeStart = std::chrono::steady_clock::now();
+        TranscriptionResult result = processor->processAudio(utterance, token);
+        const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - decodeStart;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+        }
+
+        if (result.decodedSeconds > 0.0) {
+            emit utteranceDecoded(result.decodedSeconds, decodeTime.count());
+        }
+    }
+}
+
+} // namespace audio
+} // namespace whisper_client
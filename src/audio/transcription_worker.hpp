@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include "audio/audio_processor.hpp"
+#include "audio/utterance_buffer.hpp"
+
+namespace whisper_client {
+namespace audio {
+
+// Runs AudioProcessor::processAudio on a dedicated thread so whisper never
+// blocks the GUI thread. Results are delivered through queued signals on the
+// receiver's thread. What happens to a new utterance that arrives while one
+// is still decoding is decided by the busy policy.
+class TranscriptionWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TranscriptionWorker(AudioProcessor* processor, QObject* parent = nullptr);
+    ~TranscriptionWorker();
+
+    void start();
+    void stop();
+
+    // Thread-safe; may be called while a previous utterance is decoding
+    void enqueue(UtteranceBuffer utterance);
+    int pendingJobs() const;
+
+    // "queue": decode everything in order
+    // "drop_oldest": keep at most one pending utterance, discarding older ones
+    // "preempt": abort the in-flight decode and discard anything pending
+    void setBusyPolicy(const QString& policy);
+    QString getBusyPolicy() const;
+
+    // Streaming partials: at most one is pending, a newer window replaces it,
+    // and final utterances always go first (cancelling a running partial)
+    void submitPartial(UtteranceBuffer window, qint64 windowStart);
+    void discardPartials();
+
+    // Runs AudioProcessor::calibrateThreadCount between utterances. A final
+    // utterance arriving mid-run cancels it, and it starts over once idle.
+    void requestCalibration();
+
+    // Pins the worker thread to the given cores, e.g. "0-7" or "2,4,6".
+    // Empty means no pinning. Applied when the worker starts. On Linux the
+    // ggml compute threads it spawns inherit the mask; on Windows they do
+    // not, so only the calling thread of each decode is pinned there.
+    // Elsewhere the setting is ignored. Cores past what the platform's
+    // affinity mask holds are rejected.
+    bool setCpuAffinity(const QString& cores);
+
+signals:
+    void processingChanged(bool processing);
+    void segmentReady(const QString& text, double startTime, double endTime);
+    void partialReady(const whisper_client::audio::TranscriptionResult& result, qint64 windowStart);
+    // For every decode that ran, final or partial: the audio whisper decoded
+    // (after trimming) and the wall time it took
+    void utteranceDecoded(double audioSeconds, double decodeSeconds);
+    void queueSizeChanged(int pending);
+    void utterancesDropped(int count);
+    void calibrationFinished(int threads);
+
+private:
+    void run();
+    void applyCpuAffinity();
+    static std::vector<int> parseCoreList(const QString& cores, bool* ok);
+
+    AudioProcessor* processor;
+
+    std::thread thread;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<UtteranceBuffer> jobs;
+    UtteranceBuffer partialJob;
+    qint64 partialStart;
+    bool hasPartial;
+    bool partialBusy;
+    unsigned int partialGeneration;  // Bumped by discardPartials()
+    bool stopping;
+    bool busy;
+    bool calibrating;
+    bool calibrationRequested;
+    QString busyPolicy;
+    std::vector<int> affinityCores;
+};
+
+} // namespace audio
+} // namespace whisper_client
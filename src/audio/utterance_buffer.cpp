@@ -0,0 +1,179 @@
+#include "audio/utterance_buffer.hpp"
+#include "audio/sample_convert.hpp"
+#include <algorithm>
+
+namespace whisper_client {
+namespace audio {
+
+namespace {
+
+// Round up to whole pages and at least double, so long recordings
+// reallocate O(log n) times instead of on every drain
+template <typename T>
+void reserveFor(std::vector<T>& storage, size_t required, size_t page) {
+    if (required > storage.capacity()) {
+        size_t capacity = std::max(required, storage.capacity() * 2);
+        capacity = (capacity + page - 1) / page * page;
+        storage.reserve(capacity);
+    }
+}
+
+// Takes the largest pooled buffer so a long recording reuses it
+template <typename T>
+std::vector<T> takeLargest(std::vector<std::vector<T>>& freeBuffers) {
+    std::vector<T> storage;
+    if (!freeBuffers.empty()) {
+        auto largest = std::max_element(freeBuffers.begin(), freeBuffers.end(),
+            [](const std::vector<T>& a, const std::vector<T>& b) {
+                return a.capacity() < b.capacity();
+            });
+        storage = std::move(*largest);
+        freeBuffers.erase(largest);
+    }
+    return storage;
+}
+
+template <typename T>
+void giveBack(std::vector<std::vector<T>>& freeBuffers, std::vector<T>& storage, size_t maxPooled) {
+    storage.clear();
+    if (storage.capacity() > 0 && freeBuffers.size() < maxPooled) {
+        freeBuffers.push_back(std::move(storage));
+    }
+    storage = std::vector<T>();
+}
+
+} // namespace
+
+UtteranceBuffer::UtteranceBuffer(std::vector<float>&& storage, std::shared_ptr<Pool> pool)
+    : samples(std::move(storage))
+    , pool(std::move(pool))
+{
+}
+
+UtteranceBuffer::UtteranceBuffer(std::vector<int16_t>&& storage, std::shared_ptr<Pool> pool)
+    : compactSamples(std::move(storage))
+    , compact(true)
+    , pool(std::move(pool))
+{
+}
+
+UtteranceBuffer::~UtteranceBuffer() {
+    release();
+}
+
+UtteranceBuffer& UtteranceBuffer::operator=(UtteranceBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        samples = std::move(other.samples);
+        compactSamples = std::move(other.compactSamples);
+        compact = other.compact;
+        mel = std::move(other.mel);
+        decodeOffsetMs = other.decodeOffsetMs;
+        speechBegin = other.speechBegin;
+        speechEnd = other.speechEnd;
+        hasRange = other.hasRange;
+        pool = std::move(other.pool);
+    }
+    return *this;
+}
+
+void UtteranceBuffer::append(const float* data, size_t count) {
+    const size_t page = pool ? pool->pageSamples : 1;
+    if (compact) {
+        const size_t start = compactSamples.size();
+        reserveFor(compactSamples, start + count, page);
+        compactSamples.resize(start + count);
+        floatToInt16(data, compactSamples.data() + start, count);
+        return;
+    }
+    reserveFor(samples, samples.size() + count, page);
+    samples.insert(samples.end(), data, data + count);
+}
+
+void UtteranceBuffer::append(const UtteranceBuffer& source, size_t from) {
+    if (from >= source.size()) {
+        return;
+    }
+    const size_t count = source.size() - from;
+    if (!source.compact) {
+        append(source.samples.data() + from, count);
+        return;
+    }
+
+    const size_t page = pool ? pool->pageSamples : 1;
+    if (compact) {
+        reserveFor(compactSamples, compactSamples.size() + count, page);
+        compactSamples.insert(compactSamples.end(), source.compactSamples.begin() + from, source.compactSamples.end());
+    } else {
+        const size_t start = samples.size();
+        reserveFor(samples, start + count, page);
+        samples.resize(start + count);
+        int16ToFloat(source.compactSamples.data() + from, samples.data() + start, count);
+    }
+}
+
+void UtteranceBuffer::copySamples(size_t from, size_t count, float* out) const {
+    if (compact) {
+        int16ToFloat(compactSamples.data() + from, out, count);
+    } else {
+        std::copy(samples.begin() + from, samples.begin() + from + count, out);
+    }
+}
+
+void UtteranceBuffer::clear() {
+    samples.clear();
+    compactSamples.clear();
+    mel = MelSpectrogram();
+    decodeOffsetMs = 0;
+    hasRange = false;
+}
+
+void UtteranceBuffer::release() {
+    mel = MelSpectrogram();
+    decodeOffsetMs = 0;
+    hasRange = false;
+    if (!pool) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        giveBack(pool->freeBuffers, samples, pool->maxPooled);
+        giveBack(pool->freeCompactBuffers, compactSamples, pool->maxPooled);
+    }
+    pool.reset();
+}
+
+CaptureArena::CaptureArena(size_t pageSamples, size_t maxPooled)
+    : pool(std::make_shared<UtteranceBuffer::Pool>())
+{
+    pool->pageSamples = std::max<size_t>(pageSamples, 1);
+    pool->maxPooled = maxPooled;
+}
+
+UtteranceBuffer CaptureArena::acquire(bool compact) {
+    if (compact) {
+        std::vector<int16_t> storage;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            storage = takeLargest(pool->freeCompactBuffers);
+        }
+        if (storage.capacity() == 0) {
+            storage.reserve(pool->pageSamples);
+        }
+        return UtteranceBuffer(std::move(storage), pool);
+    }
+
+    std::vector<float> storage;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        storage = takeLargest(pool->freeBuffers);
+    }
+    if (storage.capacity() == 0) {
+        storage.reserve(pool->pageSamples);
+    }
+    return UtteranceBuffer(std::move(storage), pool);
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include "audio/mel_frontend.hpp"
+
+namespace whisper_client {
+namespace audio {
+
+class CaptureArena;
+
+// Owning, move-only buffer holding one utterance of 16 kHz mono samples.
+// Storage comes from a CaptureArena and goes back to it on destruction, so
+// the capacity grown by a long recording is reused by the next one. Compact
+// buffers keep the samples as 16-bit PCM, half the size of float storage.
+class UtteranceBuffer {
+public:
+    UtteranceBuffer() = default;
+    ~UtteranceBuffer();
+
+    UtteranceBuffer(UtteranceBuffer&& other) noexcept = default;
+    UtteranceBuffer& operator=(UtteranceBuffer&& other) noexcept;
+    UtteranceBuffer(const UtteranceBuffer&) = delete;
+    UtteranceBuffer& operator=(const UtteranceBuffer&) = delete;
+
+    // Float storage only; compact buffers are read through copySamples()
+    const float* data() const { return samples.data(); }
+    size_t size() const { return compact ? compactSamples.size() : samples.size(); }
+    bool empty() const { return size() == 0; }
+    bool isCompact() const { return compact; }
+
+    void append(const float* data, size_t count);
+    void append(const UtteranceBuffer& source, size_t from);  // source[from, end)
+    void copySamples(size_t from, size_t count, float* out) const;
+    void clear();
+
+    // Log-mel spectrogram computed while the utterance was being captured
+    void setMel(MelSpectrogram&& spectrogram) { mel = std::move(spectrogram); }
+    const MelSpectrogram& getMel() const { return mel; }
+    bool hasMel() const { return !mel.empty(); }
+
+    // Audio before this point was already transcribed (e.g. committed by
+    // streaming partials) and only provides context
+    void setDecodeOffsetMs(int ms) { decodeOffsetMs = ms; }
+    int getDecodeOffsetMs() const { return decodeOffsetMs; }
+
+    // Span the voice activity detector found speech in; samples outside it
+    // are not decoded. Without a range the whole buffer is speech.
+    void setSpeechRange(size_t begin, size_t end) { speechBegin = begin; speechEnd = end; hasRange = true; }
+    bool hasSpeechRange() const { return hasRange; }
+    bool hasSpeech() const { return !hasRange || speechEnd > speechBegin; }
+    size_t getSpeechBegin() const { return hasRange ? speechBegin : 0; }
+    size_t getSpeechEnd() const { return hasRange ? speechEnd : size(); }
+
+private:
+    friend class CaptureArena;
+
+    struct Pool {
+        std::mutex mutex;
+        std::vector<std::vector<float>> freeBuffers;
+        std::vector<std::vector<int16_t>> freeCompactBuffers;
+        size_t pageSamples;
+        size_t maxPooled;
+    };
+
+    UtteranceBuffer(std::vector<float>&& storage, std::shared_ptr<Pool> pool);
+    UtteranceBuffer(std::vector<int16_t>&& storage, std::shared_ptr<Pool> pool);
+    void release();
+
+    std::vector<float> samples;
+    std::vector<int16_t> compactSamples;
+    bool compact = false;
+    MelSpectrogram mel;
+    int decodeOffsetMs = 0;
+    size_t speechBegin = 0;
+    size_t speechEnd = 0;
+    bool hasRange = false;
+    std::shared_ptr<Pool> pool;
+};
+
+// Hands out UtteranceBuffers backed by recycled storage. Buffers grow
+// geometrically in whole pages, and once the arena has seen a recording of
+// a given length, later recordings up to that length never reallocate.
+class CaptureArena {
+public:
+    explicit CaptureArena(size_t pageSamples, size_t maxPooled = 4);
+
+    UtteranceBuffer acquire(bool compact = false);
+
+private:
+    std::shared_ptr<UtteranceBuffer::Pool> pool;
+};
+
+} // namespace audio
+} // namespace whisper_client
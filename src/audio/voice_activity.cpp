@@ -0,0 +1,193 @@
+#include "audio/voice_activity.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace whisper_client {
+namespace audio {
+
+VoiceActivityDetector::VoiceActivityDetector()
+    : frameSum(0.0)
+    , frameFill(0)
+    , totalSamples(0)
+{
+}
+
+void VoiceActivityDetector::reset() {
+    frameEnergies.clear();
+    frameSum = 0.0;
+    frameFill = 0;
+    totalSamples = 0;
+}
+
+void VoiceActivityDetector::addSamples(const float* samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        frameSum += double(samples[i]) * samples[i];
+        if (++frameFill == FRAME_SAMPLES) {
+            frameEnergies.push_back(static_cast<float>(10.0 * std::log10(frameSum / FRAME_SAMPLES + 1e-10)));
+            frameSum = 0.0;
+            frameFill = 0;
+        }
+    }
+    totalSamples += count;
+}
+
+VoiceActivityDetector::SpeechRange VoiceActivityDetector::analyse() const {
+    SpeechRange range;
+    const size_t frames = frameEnergies.size();
+    if (frames < MIN_SPEECH_FRAMES) {
+        return range;
+    }
+
+    std::vector<float> sorted(frameEnergies);
+    const size_t floorIndex = static_cast<size_t>(frames * NOISE_PERCENTILE);
+    std::nth_element(sorted.begin(), sorted.begin() + floorIndex, sorted.end());
+    const float floor = sorted[floorIndex];
+    const float loudest = *std::max_element(frameEnergies.begin(), frameEnergies.end());
+
+    // A clip spoken from press to release without a pause has no quiet
+    // frames to measure the floor from; the percentile then sits at the
+    // speech level, so judge such a clip by its absolute level instead
+    const float threshold = loudest - floor < SPEECH_ABOVE_FLOOR_DB
+        ? FLAT_CLIP_SPEECH_DB
+        : std::max(floor + SPEECH_ABOVE_FLOOR_DB, MIN_SPEECH_DB);
+
+    // Voiced runs of at least MIN_RUN_FRAMES count towards speech
+    size_t first = frames;
+    size_t last = 0;
+    size_t voiced = 0;
+    size_t run = 0;
+    for (size_t i = 0; i <= frames; ++i) {
+        if (i < frames && frameEnergies[i] > threshold) {
+            ++run;
+            continue;
+        }
+        if (run >= MIN_RUN_FRAMES) {
+            first = std::min(first, i - run);
+            last = i;  // One past the run
+            voiced += run;
+        }
+        run = 0;
+    }
+
+    if (voiced < MIN_SPEECH_FRAMES) {
+        return range;
+    }
+
+    range.speech = true;
+    range.begin = (first > PAD_BEFORE_FRAMES ? first - PAD_BEFORE_FRAMES : 0) * FRAME_SAMPLES;
+    range.end = std::min(totalSamples, (last + PAD_AFTER_FRAMES) * FRAME_SAMPLES);
+    if (last + PAD_AFTER_FRAMES >= frames) {
+        range.end = totalSamples;  // Keep the partial frame at the end too
+    }
+    return range;
+}
+
+SpeechEndpointer::SpeechEndpointer()
+    : noiseFloorDb(INITIAL_FLOOR_DB)
+    , recentEnergies(FLOOR_WINDOW_FRAMES, INITIAL_FLOOR_DB)
+    , floorScratch(FLOOR_WINDOW_FRAMES)
+    , recentPos(0)
+    , recentCount(0)
+    , peakDb(INITIAL_FLOOR_DB)
+    , frameSum(0.0)
+    , frameFill(0)
+    , speaking(false)
+    , voicedRun(0)
+    , silentRun(0)
+    , voicedFrames(0)
+    , utteranceFrames(0)
+    , timeoutFrames(35)  // 700 ms
+{
+}
+
+void SpeechEndpointer::reset() {
+    noiseFloorDb = INITIAL_FLOOR_DB;
+    recentPos = 0;
+    recentCount = 0;
+    peakDb = INITIAL_FLOOR_DB;
+    frameSum = 0.0;
+    frameFill = 0;
+    speaking = false;
+    voicedRun = 0;
+    silentRun = 0;
+    voicedFrames = 0;
+    utteranceFrames = 0;
+}
+
+void SpeechEndpointer::setEndpointTimeoutMs(unsigned int ms) {
+    timeoutFrames = std::max(1u, static_cast<unsigned int>(ms * 16 / FRAME_SAMPLES));
+}
+
+size_t SpeechEndpointer::feed(const float* samples, size_t count, Event* event) {
+    *event = Event::None;
+    for (size_t i = 0; i < count; ++i) {
+        frameSum += double(samples[i]) * samples[i];
+        if (++frameFill < FRAME_SAMPLES) {
+            continue;
+        }
+
+        const float energyDb = static_cast<float>(10.0 * std::log10(frameSum / FRAME_SAMPLES + 1e-10));
+        frameSum = 0.0;
+        frameFill = 0;
+        *event = classifyFrame(energyDb);
+        if (*event != Event::None) {
+            return i + 1;
+        }
+    }
+    return count;
+}
+
+void SpeechEndpointer::updateNoiseFloor(float energyDb) {
+    recentEnergies[recentPos] = energyDb;
+    recentPos = (recentPos + 1) % FLOOR_WINDOW_FRAMES;
+    recentCount = std::min(recentCount + 1, FLOOR_WINDOW_FRAMES);
+
+    std::copy(recentEnergies.begin(), recentEnergies.begin() + recentCount, floorScratch.begin());
+    auto floor = floorScratch.begin() + static_cast<size_t>(recentCount * NOISE_PERCENTILE);
+    std::nth_element(floorScratch.begin(), floor, floorScratch.begin() + recentCount);
+    noiseFloorDb = *floor;
+}
+
+SpeechEndpointer::Event SpeechEndpointer::classifyFrame(float energyDb) {
+    const bool voiced = recentCount >= FLOOR_WARMUP_FRAMES &&
+                        energyDb > std::max(noiseFloorDb + SPEECH_ABOVE_FLOOR_DB, MIN_SPEECH_DB);
+    updateNoiseFloor(energyDb);
+
+    voicedRun = voiced ? voicedRun + 1 : 0;
+
+    if (!speaking) {
+        if (voicedRun >= ONSET_FRAMES) {
+            speaking = true;
+            silentRun = 0;
+            voicedFrames = voicedRun;
+            utteranceFrames = voicedRun;
+            peakDb = energyDb;
+            return Event::SpeechStart;
+        }
+        return Event::None;
+    }
+
+    ++utteranceFrames;
+    peakDb = std::max(peakDb, energyDb);
+    if (voiced) {
+        ++voicedFrames;
+        silentRun = 0;
+    } else {
+        ++silentRun;
+    }
+
+    if (silentRun >= timeoutFrames || utteranceFrames >= MAX_UTTERANCE_FRAMES) {
+        speaking = false;
+        voicedRun = 0;
+
+        // A rise in background noise opens an utterance too, until the floor
+        // catches up with it; by the end its loudest frame is barely above
+        // the new floor, where speech stands well clear of it
+        const bool clear = peakDb >= noiseFloorDb + PEAK_ABOVE_FLOOR_DB;
+        return (voicedFrames >= MIN_SPEECH_FRAMES && clear) ? Event::SpeechEnd : Event::SpeechDiscard;
+    }
+    return Event::None;
+}
+
+} // namespace audio
+} // namespace whisper_client
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace whisper_client {
+namespace audio {
+
+// Energy-based voice activity detector for 16 kHz mono audio. Frame
+// energies are computed as samples arrive; the decision runs once at the end
+// of the clip against a noise floor estimated from the clip itself, so it
+// adapts to the microphone without a calibration phase.
+class VoiceActivityDetector {
+public:
+    struct SpeechRange {
+        size_t begin = 0;    // First sample to decode
+        size_t end = 0;      // One past the last sample to decode
+        bool speech = false; // False when the clip holds no speech at all
+    };
+
+    VoiceActivityDetector();
+
+    void reset();
+    void addSamples(const float* samples, size_t count);
+    size_t sampleCount() const { return totalSamples; }
+
+    // Speech span with some padding either side, over everything fed since reset()
+    SpeechRange analyse() const;
+
+private:
+    static constexpr size_t FRAME_SAMPLES = 320;        // 20 ms
+    static constexpr float NOISE_PERCENTILE = 0.1f;     // Quietest 10% of frames is the noise floor
+    static constexpr float SPEECH_ABOVE_FLOOR_DB = 10.0f;
+    static constexpr float MIN_SPEECH_DB = -55.0f;      // Absolute gate, dBFS
+    static constexpr float FLAT_CLIP_SPEECH_DB = -45.0f; // Gate for clips with no quieter stretch
+    static constexpr size_t MIN_RUN_FRAMES = 2;         // Ignore isolated clicks
+    static constexpr size_t MIN_SPEECH_FRAMES = 10;     // 200 ms of speech in total
+    static constexpr size_t PAD_BEFORE_FRAMES = 12;     // 240 ms
+    static constexpr size_t PAD_AFTER_FRAMES = 15;      // 300 ms
+
+    std::vector<float> frameEnergies;  // dBFS per complete frame
+    double frameSum;
+    size_t frameFill;
+    size_t totalSamples;
+};
+
+// Streaming endpointer for hands-free capture. Tracks the noise floor as a
+// low percentile of the last few seconds, so it settles on a new noise level
+// within seconds while the gaps between words keep it down during speech.
+// Reports where speech starts and, after a run of trailing silence, where it
+// ends. Works in 20 ms frames like VoiceActivityDetector.
+class SpeechEndpointer {
+public:
+    enum class Event {
+        None,
+        SpeechStart,    // Enough voiced frames in a row to open an utterance
+        SpeechEnd,      // Trailing silence reached the timeout, or the utterance hit the length cap
+        SpeechDiscard   // Utterance ended without enough speech to be worth decoding
+    };
+
+    SpeechEndpointer();
+
+    void reset();
+    void setEndpointTimeoutMs(unsigned int ms);
+    bool inSpeech() const { return speaking; }
+
+    // Consumes samples up to and including the first frame that raises an
+    // event, stores it in *event and returns the number of samples used.
+    size_t feed(const float* samples, size_t count, Event* event);
+
+private:
+    Event classifyFrame(float energyDb);
+    void updateNoiseFloor(float energyDb);
+
+    static constexpr size_t FRAME_SAMPLES = 320;             // 20 ms
+    static constexpr float SPEECH_ABOVE_FLOOR_DB = 10.0f;
+    static constexpr float MIN_SPEECH_DB = -55.0f;           // Absolute gate, dBFS
+    static constexpr float INITIAL_FLOOR_DB = -60.0f;
+    static constexpr size_t FLOOR_WINDOW_FRAMES = 250;       // 5 s
+    static constexpr float NOISE_PERCENTILE = 0.1f;
+    static constexpr size_t FLOOR_WARMUP_FRAMES = 25;        // No onsets before 500 ms of floor history
+    static constexpr float PEAK_ABOVE_FLOOR_DB = 15.0f;      // Utterances that never get this loud are noise
+    static constexpr unsigned int ONSET_FRAMES = 3;          // 60 ms
+    static constexpr unsigned int MIN_SPEECH_FRAMES = 10;    // 200 ms
+    static constexpr unsigned int MAX_UTTERANCE_FRAMES = 1500;  // 30 s, one whisper window
+
+    float noiseFloorDb;
+    std::vector<float> recentEnergies;  // Ring of the last FLOOR_WINDOW_FRAMES frame energies
+    std::vector<float> floorScratch;    // Preallocated; the drain thread never allocates
+    size_t recentPos;
+    size_t recentCount;
+    float peakDb;                // Loudest frame of the current utterance
+    double frameSum;
+    size_t frameFill;
+    bool speaking;
+    unsigned int voicedRun;      // Consecutive voiced frames
+    unsigned int silentRun;      // Consecutive unvoiced frames while speaking
+    unsigned int voicedFrames;   // Voiced frames in the current utterance
+    unsigned int utteranceFrames;
+    unsigned int timeoutFrames;
+};
+
+} // namespace audio
+} // namespace whisper_client
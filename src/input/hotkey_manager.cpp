@@ -13,6 +13,7 @@ HotkeyManager::HotkeyManager(QObject* parent)
     , isRunning(false)
     , recordingMode("push")
     , isRecording(false)
+    , isListening(true)
     , recordingKey(0)
 {
     instance = this;
@@ -80,8 +81,9 @@ bool HotkeyManager::setActionHotkey(const QString& action, const QString& key) {
 }
 
 void HotkeyManager::setRecordingMode(const QString& mode) {
-    if (mode == "push" || mode == "toggle") {
+    if (mode == "push" || mode == "toggle" || mode == "continuous") {
         recordingMode = mode;
+        isListening = true;
         qDebug() << "Recording mode set to:" << mode;
     }
 }
@@ -118,6 +120,10 @@ void HotkeyManager::handleKeyPress(int vkCode) {
                 emit recordingStopped();
             }
         }
+        else if (recordingMode == "continuous") {
+            isListening = !isListening;
+            emit listeningChanged(isListening);
+        }
     }
 
     // Handle action hotkeys
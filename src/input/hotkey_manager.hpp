@@ -20,7 +20,7 @@ public:
     // Hotkey management
     bool setRecordingHotkey(const QString& key);
     bool setActionHotkey(const QString& action, const QString& key);
-    void setRecordingMode(const QString& mode);  // "push" or "toggle"
+    void setRecordingMode(const QString& mode);  // "push", "toggle" or "continuous"
     
     // Start/Stop monitoring
     bool start();
@@ -29,6 +29,7 @@ public:
 signals:
     void recordingStarted();
     void recordingStopped();
+    void listeningChanged(bool listening);  // Continuous mode: the hotkey pauses and resumes
     void actionTriggered(const QString& action);
 
 private:
@@ -44,8 +45,9 @@ private:
 
     HHOOK keyboardHook;
     bool isRunning;
-    QString recordingMode;  // "push" or "toggle"
+    QString recordingMode;  // "push", "toggle" or "continuous"
     bool isRecording;
+    bool isListening;       // Continuous mode starts listening
 
     // Hotkey storage
     int recordingKey;
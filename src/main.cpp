@@ -1,5 +1,7 @@
 #include "ui/main_window.hpp"
+#include "audio/context_benchmark.hpp"
 #include <QApplication>
+#include <QCommandLineParser>
 #include <stdexcept>
 #include <iostream>
 
@@ -7,6 +9,20 @@ int main(int argc, char *argv[]) {
     try {
         QApplication app(argc, argv);
 
+        // Offline benchmark mode, no window
+        QCommandLineParser parser;
+        QCommandLineOption benchmarkOption("benchmark-audio-ctx",
+            "Benchmark the short-clip fast path on a 16 kHz WAV file and exit.", "wav");
+        QCommandLineOption threadsOption("threads", "Inference threads for the benchmark.", "n", "0");
+        parser.addHelpOption();
+        parser.addOption(benchmarkOption);
+        parser.addOption(threadsOption);
+        parser.process(app);
+        if (parser.isSet(benchmarkOption)) {
+            return whisper_client::audio::runContextBenchmark(
+                parser.value(benchmarkOption), parser.value(threadsOption).toInt());
+        }
+
         // Set application style
         app.setStyle("Fusion");
 
@@ -0,0 +1,346 @@
+#include "network/segmented_download.hpp"
+#include <QtCore/QDebug>
+#include <QtNetwork/QNetworkRequest>
+#include <algorithm>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <winioctl.h>
+#endif
+
+namespace whisper_client {
+namespace network {
+
+namespace {
+
+// NTFS fills the gap with zeros synchronously when a file is extended,
+// unless the file is marked sparse first. Elsewhere resizing is already
+// sparse.
+void markSparse(const QString& filePath) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(reinterpret_cast<const wchar_t*>(filePath.utf16()),
+                              GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    DWORD returned = 0;
+    if (!DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr)) {
+        qDebug() << "Could not mark download sparse. Error:" << GetLastError();
+    }
+    CloseHandle(file);
+#else
+    (void)filePath;
+#endif
+}
+
+} // namespace
+
+SegmentedDownload::SegmentedDownload(QNetworkAccessManager* networkManager, QObject* parent)
+    : QObject(parent)
+    , networkManager(networkManager)
+    , probeReply(nullptr)
+    , segmentCount(1)
+    , running(false)
+    , totalBytes(0)
+    , hashTarget(0)
+    , hashStopping(false)
+    , generation(0)
+{
+}
+
+SegmentedDownload::~SegmentedDownload() {
+    abort();
+}
+
+void SegmentedDownload::start(const QUrl& sourceUrl, const QString& filePath, int count) {
+    abort();
+
+    url = sourceUrl;
+    segmentCount = std::max(1, count);
+    writeFile.setFileName(filePath);
+    totalBytes = 0;
+    running = true;
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+    probeReply = networkManager->head(request);
+    connect(probeReply, &QNetworkReply::finished, this, &SegmentedDownload::onProbeFinished);
+}
+
+void SegmentedDownload::onProbeFinished() {
+    QNetworkReply* reply = probeReply;
+    probeReply = nullptr;
+    reply->deleteLater();
+    if (!running) {
+        return;
+    }
+
+    const qint64 length = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+    const bool acceptsRanges = reply->rawHeader("Accept-Ranges").trimmed().toLower() == "bytes";
+    if (reply->error() != QNetworkReply::NoError || length <= 0 || !acceptsRanges) {
+        running = false;
+        emit rangesUnsupported();
+        return;
+    }
+
+    // Segment requests go to wherever the redirects ended up
+    url = reply->url();
+    totalBytes = length;
+
+    // Preallocate as a sparse file
+    markSparse(writeFile.fileName());
+    if (!writeFile.open(QIODevice::WriteOnly | QIODevice::Unbuffered) ||
+        !writeFile.resize(totalBytes)) {
+        fail("Failed to preallocate model file");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(hashMutex);
+        hashTarget = 0;
+        hashStopping = false;
+    }
+    hashThread = std::thread(&SegmentedDownload::hashLoop, this, writeFile.fileName(), totalBytes, generation);
+
+    const int count = static_cast<int>(std::clamp<qint64>(totalBytes / MIN_SEGMENT_BYTES, 1, segmentCount));
+    const qint64 segmentBytes = (totalBytes + count - 1) / count;
+    segments.assign(count, Segment());
+    for (int i = 0; i < count; ++i) {
+        segments[i].start = i * segmentBytes;
+        segments[i].end = std::min(totalBytes, (i + 1) * segmentBytes) - 1;
+    }
+
+    qDebug() << "Downloading" << totalBytes << "bytes in" << count << "segments";
+    for (size_t i = 0; i < segments.size(); ++i) {
+        startSegment(i);
+    }
+}
+
+void SegmentedDownload::startSegment(size_t index) {
+    Segment& segment = segments[index];
+    segment.statusChecked = false;
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+    request.setRawHeader("Range", QString("bytes=%1-%2")
+                                      .arg(segment.start + segment.written)
+                                      .arg(segment.end)
+                                      .toLatin1());
+
+    segment.reply = networkManager->get(request);
+    connect(segment.reply, &QNetworkReply::readyRead, this, [this, index]() {
+        onSegmentReadyRead(index);
+    });
+    connect(segment.reply, &QNetworkReply::finished, this, [this, index]() {
+        onSegmentFinished(index);
+    });
+}
+
+void SegmentedDownload::onSegmentReadyRead(size_t index) {
+    Segment& segment = segments[index];
+    if (!running || !segment.reply) {
+        return;
+    }
+
+    // Anything but a partial response would be the wrong bytes. HTTP and
+    // network errors are left to the retry in onSegmentFinished.
+    if (!segment.statusChecked) {
+        const int status = segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status == 200 && segment.reply->error() == QNetworkReply::NoError) {
+            // Advertised ranges but ignored them; a single stream still works
+            qDebug() << "Server ignored a range request";
+            running = false;
+            ++generation;
+            releaseReplies();
+            stopHashing();
+            writeFile.close();
+            QFile::remove(writeFile.fileName());
+            emit rangesUnsupported();
+            return;
+        }
+        if (status != 206) {
+            if (segment.reply->error() == QNetworkReply::NoError && status != 0) {
+                fail(QString("Server answered a range request with HTTP %1").arg(status));
+            }
+            return;
+        }
+        // The file must not have changed size since the probe
+        const QByteArray contentRange = segment.reply->rawHeader("Content-Range").trimmed();
+        if (!contentRange.endsWith("/" + QByteArray::number(totalBytes))) {
+            fail("Server reported a different file size: " + QString::fromLatin1(contentRange));
+            return;
+        }
+        segment.statusChecked = true;
+    }
+
+    const qint64 remaining = segment.end + 1 - (segment.start + segment.written);
+    const QByteArray chunk = segment.reply->read(remaining);
+    if (chunk.isEmpty()) {
+        return;
+    }
+
+    if (!writeFile.seek(segment.start + segment.written) || writeFile.write(chunk) != chunk.size()) {
+        fail("Failed to write model data: " + writeFile.errorString());
+        return;
+    }
+    segment.written += chunk.size();
+
+    qint64 received = 0;
+    for (const auto& s : segments) {
+        received += s.written;
+    }
+    emit progress(received, totalBytes);
+
+    advanceHash();
+}
+
+void SegmentedDownload::onSegmentFinished(size_t index) {
+    Segment& segment = segments[index];
+    if (!running || !segment.reply) {
+        return;
+    }
+
+    QNetworkReply* reply = segment.reply;
+    onSegmentReadyRead(index);  // Anything still buffered
+    if (!running) {
+        return;
+    }
+    segment.reply = nullptr;
+    reply->deleteLater();
+
+    const bool complete = segment.start + segment.written > segment.end;
+    if (!complete) {
+        if (++segment.retries > MAX_RETRIES) {
+            fail(QString("Segment %1 failed: %2").arg(index).arg(reply->errorString()));
+            return;
+        }
+        qDebug() << "Retrying segment" << index << "from byte" << segment.start + segment.written
+                 << "after:" << reply->errorString();
+        startSegment(index);
+    }
+
+    // finished is emitted by the hash thread once it reaches the end
+}
+
+void SegmentedDownload::advanceHash() {
+    // Extend over the contiguous written prefix: whole segments that are done,
+    // then the written part of the first unfinished one
+    qint64 contiguous = 0;
+    for (const auto& segment : segments) {
+        contiguous = segment.start + segment.written;
+        if (contiguous <= segment.end) {
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(hashMutex);
+        if (contiguous <= hashTarget) {
+            return;
+        }
+        hashTarget = contiguous;
+    }
+    hashCondition.notify_one();
+}
+
+void SegmentedDownload::hashLoop(const QString& filePath, qint64 total, unsigned int run) {
+    // Reads back what the segments wrote, in order, through its own handle
+    QFile file(filePath);
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QByteArray chunk(4 * 1024 * 1024, Qt::Uninitialized);
+    qint64 hashed = 0;
+    bool readable = file.open(QIODevice::ReadOnly);
+
+    while (readable && hashed < total) {
+        qint64 target;
+        {
+            std::unique_lock<std::mutex> lock(hashMutex);
+            hashCondition.wait(lock, [this, hashed]() { return hashStopping || hashTarget > hashed; });
+            if (hashStopping) {
+                return;
+            }
+            target = hashTarget;
+        }
+
+        while (hashed < target) {
+            const qint64 n = file.read(chunk.data(), std::min<qint64>(chunk.size(), target - hashed));
+            if (n <= 0) {
+                readable = false;
+                break;
+            }
+            hash.addData(QByteArrayView(chunk.constData(), n));
+            hashed += n;
+        }
+    }
+
+    const QString sha256 = readable ? QString(hash.result().toHex()) : QString();
+    QMetaObject::invokeMethod(this, [this, sha256, run]() {
+        if (run != generation || !running) {
+            return;
+        }
+        if (sha256.isEmpty()) {
+            fail("Failed to read back model data");
+            return;
+        }
+        running = false;
+        stopHashing();
+        writeFile.close();
+        emit finished(true, sha256, QString());
+    }, Qt::QueuedConnection);
+}
+
+void SegmentedDownload::stopHashing() {
+    {
+        std::lock_guard<std::mutex> lock(hashMutex);
+        hashStopping = true;
+    }
+    hashCondition.notify_one();
+    if (hashThread.joinable()) {
+        hashThread.join();
+    }
+}
+
+void SegmentedDownload::fail(const QString& errorMessage) {
+    if (!running) {
+        return;
+    }
+    running = false;
+    ++generation;
+    releaseReplies();
+    stopHashing();
+    writeFile.close();
+    emit finished(false, QString(), errorMessage);
+}
+
+void SegmentedDownload::abort() {
+    running = false;
+    ++generation;
+    releaseReplies();
+    stopHashing();
+    writeFile.close();
+}
+
+void SegmentedDownload::releaseReplies() {
+    if (probeReply) {
+        probeReply->disconnect(this);
+        probeReply->abort();
+        probeReply->deleteLater();
+        probeReply = nullptr;
+    }
+    for (auto& segment : segments) {
+        if (segment.reply) {
+            segment.reply->disconnect(this);
+            segment.reply->abort();
+            segment.reply->deleteLater();
+            segment.reply = nullptr;
+        }
+    }
+}
+
+} // namespace network
+} // namespace whisper_client
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QFile>
+#include <QtCore/QUrl>
+#include <QtCore/QCryptographicHash>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace whisper_client {
+namespace network {
+
+// Downloads one file as several byte ranges in parallel, written in place
+// into a preallocated file. Each range retries on its own after a failure.
+// The SHA-256 is computed on a background thread that follows the contiguous
+// prefix of the file as it fills in, so the file does not need a second pass
+// once the last range lands and the GUI thread never reads it back.
+class SegmentedDownload : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SegmentedDownload(QNetworkAccessManager* networkManager, QObject* parent = nullptr);
+    ~SegmentedDownload();
+
+    // Probes the server with HEAD first. Emits rangesUnsupported instead of
+    // starting if it does not advertise byte ranges or a length, and
+    // abandons the file with the same signal if a range request is answered
+    // with the whole body.
+    void start(const QUrl& url, const QString& filePath, int segments);
+    void abort();
+    bool isRunning() const { return running; }
+    qint64 totalSize() const { return totalBytes; }
+
+signals:
+    void progress(qint64 bytesReceived, qint64 bytesTotal);
+    void finished(bool success, const QString& sha256, const QString& errorMessage);
+    void rangesUnsupported();
+
+private:
+    struct Segment {
+        qint64 start = 0;
+        qint64 end = 0;        // Inclusive
+        qint64 written = 0;
+        int retries = 0;
+        QNetworkReply* reply = nullptr;
+        bool statusChecked = false;
+    };
+
+    void onProbeFinished();
+    void startSegment(size_t index);
+    void onSegmentReadyRead(size_t index);
+    void onSegmentFinished(size_t index);
+    void advanceHash();
+    void hashLoop(const QString& filePath, qint64 total, unsigned int run);
+    void stopHashing();
+    void fail(const QString& errorMessage);
+    void releaseReplies();
+
+    QNetworkAccessManager* networkManager;
+    QNetworkReply* probeReply;
+    QUrl url;
+    int segmentCount;
+    bool running;
+
+    QFile writeFile;   // Unbuffered, so the hash reader sees every write
+    qint64 totalBytes;
+    std::vector<Segment> segments;
+
+    // Hash thread; hashTarget is the contiguous prefix written so far
+    std::thread hashThread;
+    std::mutex hashMutex;
+    std::condition_variable hashCondition;
+    qint64 hashTarget;
+    bool hashStopping;
+    unsigned int generation;  // Bumped per run so stale hash results are ignored
+
+    static constexpr int MAX_RETRIES = 3;
+    static constexpr qint64 MIN_SEGMENT_BYTES = 8 * 1024 * 1024;
+};
+
+} // namespace network
+} // namespace whisper_client
@@ -125,6 +125,20 @@ void WebSocketClient::sendTranscript(const QString& username, const QString& tex
     sendMessage(message);
 }
 
+void WebSocketClient::sendTranscript(const QString& username, const QString& text, int sequence, bool isFinal) {
+    if (!connected) return;
+
+    QJsonObject message;
+    message["type"] = "transcript";
+    message["username"] = username;
+    message["content"] = text;
+    message["sequence"] = sequence;
+    message["final"] = isFinal;
+    message["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    sendMessage(message);
+}
+
 void WebSocketClient::sendAction(const QString& actionType) {
     if (!connected) return;
 
@@ -24,6 +24,9 @@ public:
 
     // Message sending
     void sendTranscript(const QString& username, const QString& text);
+    // Streamed form: provisional text (isFinal == false) carries the sequence
+    // number of the final transcript that will replace it
+    void sendTranscript(const QString& username, const QString& text, int sequence, bool isFinal);
     void sendAction(const QString& actionType);
     void sendBotControl(bool connect);
 
@@ -0,0 +1,424 @@
+#include "storage/transcript_journal.hpp"
+#include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+#include <QtCore/QDebug>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <set>
+
+namespace whisper_client {
+namespace storage {
+
+TranscriptJournal::TranscriptJournal()
+    : recordsMap(nullptr)
+    , recordsMapped(0)
+    , stringsMap(nullptr)
+    , stringsMapped(0)
+    , indexMap(nullptr)
+    , indexMapped(0)
+    , recordCount(0)
+    , stringsSize(0)
+    , indexedCount(0)
+{
+}
+
+TranscriptJournal::~TranscriptJournal() {
+    close();
+}
+
+bool TranscriptJournal::open(const QString& path) {
+    close();
+
+    directory = path;
+    QDir().mkpath(directory);
+
+    recordsFile.setFileName(directory + "/records.bin");
+    stringsFile.setFileName(directory + "/strings.bin");
+    if (!recordsFile.open(QIODevice::ReadWrite) || !stringsFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open transcript journal in" << directory;
+        close();
+        return false;
+    }
+
+    // Drop a record torn by a crash; stray arena bytes after it are harmless
+    const qint64 wholeRecords = recordsFile.size() / static_cast<qint64>(sizeof(Record));
+    if (recordsFile.size() != wholeRecords * static_cast<qint64>(sizeof(Record))) {
+        recordsFile.resize(wholeRecords * sizeof(Record));
+    }
+    recordCount = static_cast<quint32>(wholeRecords);
+    stringsSize = static_cast<quint64>(stringsFile.size());
+
+    if (!loadIndex()) {
+        indexedCount = 0;
+    }
+
+    // Catch the in-memory index up with records the index file does not cover
+    for (quint32 id = indexedCount; id < recordCount; ++id) {
+        const Record* record = recordAt(id);
+        if (record) {
+            indexRecord(id, stringAt(record->userOffset, record->userLength),
+                        stringAt(record->textOffset, record->textLength));
+        }
+    }
+
+    qDebug() << "Transcript journal opened with" << recordCount << "entries";
+    return true;
+}
+
+void TranscriptJournal::close() {
+    if (recordsFile.isOpen() && !tailIndex.empty()) {
+        writeIndex();
+    }
+
+    if (recordsMap) {
+        recordsFile.unmap(recordsMap);
+    }
+    if (stringsMap) {
+        stringsFile.unmap(stringsMap);
+    }
+    if (indexMap) {
+        indexFile.unmap(indexMap);
+    }
+    recordsMap = stringsMap = indexMap = nullptr;
+    recordsMapped = stringsMapped = indexMapped = 0;
+
+    recordsFile.close();
+    stringsFile.close();
+    indexFile.close();
+    tailIndex.clear();
+    recordCount = 0;
+    indexedCount = 0;
+    stringsSize = 0;
+}
+
+bool TranscriptJournal::append(const QString& username, const QString& text, const QDateTime& timestamp) {
+    if (!isOpen() || text.trimmed().isEmpty()) {
+        return false;
+    }
+
+    const QByteArray user = username.toUtf8();
+    const QByteArray body = text.toUtf8();
+
+    Record record;
+    record.timestampMs = timestamp.toMSecsSinceEpoch();
+    record.userOffset = stringsSize;
+    record.userLength = static_cast<quint32>(user.size());
+    record.textOffset = stringsSize + user.size();
+    record.textLength = static_cast<quint32>(body.size());
+
+    // Strings first, so a record never points past the arena
+    if (!stringsFile.seek(static_cast<qint64>(stringsSize)) ||
+        stringsFile.write(user) != user.size() ||
+        stringsFile.write(body) != body.size() ||
+        !stringsFile.flush()) {
+        qWarning() << "Failed to append to transcript journal:" << stringsFile.errorString();
+        return false;
+    }
+    stringsSize += user.size() + body.size();
+
+    if (!recordsFile.seek(static_cast<qint64>(recordCount) * sizeof(Record)) ||
+        recordsFile.write(reinterpret_cast<const char*>(&record), sizeof(Record)) != sizeof(Record) ||
+        !recordsFile.flush()) {
+        qWarning() << "Failed to append to transcript journal:" << recordsFile.errorString();
+        return false;
+    }
+
+    indexRecord(recordCount, username, text);
+    ++recordCount;
+
+    if (recordCount - indexedCount >= MAX_TAIL_RECORDS) {
+        writeIndex();
+    }
+    return true;
+}
+
+bool TranscriptJournal::remap(QFile& file, uchar*& mapping, qint64& mappedSize) {
+    // Mappings cover the file as it was; grow them after appends
+    const qint64 size = file.size();
+    if (mapping && mappedSize == size) {
+        return true;
+    }
+    if (mapping) {
+        file.unmap(mapping);
+        mapping = nullptr;
+        mappedSize = 0;
+    }
+    if (size == 0) {
+        return false;
+    }
+    mapping = file.map(0, size);
+    mappedSize = mapping ? size : 0;
+    return mapping != nullptr;
+}
+
+const TranscriptJournal::Record* TranscriptJournal::recordAt(quint32 id) {
+    const qint64 end = (static_cast<qint64>(id) + 1) * sizeof(Record);
+    if (id >= recordCount || (end > recordsMapped && !remap(recordsFile, recordsMap, recordsMapped))) {
+        return nullptr;
+    }
+    return reinterpret_cast<const Record*>(recordsMap + static_cast<qint64>(id) * sizeof(Record));
+}
+
+QString TranscriptJournal::stringAt(quint64 offset, quint32 length) {
+    const quint64 end = offset + length;
+    if (end > stringsSize || (static_cast<qint64>(end) > stringsMapped && !remap(stringsFile, stringsMap, stringsMapped))) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char*>(stringsMap + offset), static_cast<int>(length));
+}
+
+JournalEntry TranscriptJournal::entry(quint32 id) {
+    JournalEntry result;
+    const Record* record = recordAt(id);
+    if (!record) {
+        return result;
+    }
+    result.id = id;
+    result.timestamp = QDateTime::fromMSecsSinceEpoch(record->timestampMs);
+    result.username = stringAt(record->userOffset, record->userLength);
+    result.text = stringAt(record->textOffset, record->textLength);
+    return result;
+}
+
+std::vector<QByteArray> TranscriptJournal::tokenize(const QString& text) {
+    // Lower-cased runs of letters and digits; apostrophes stay inside words
+    std::vector<QByteArray> tokens;
+    QString current;
+    auto flush = [&tokens, &current]() {
+        if (!current.isEmpty()) {
+            tokens.push_back(current.toUtf8());
+            current.clear();
+        }
+    };
+    for (const QChar c : text) {
+        if (c.isLetterOrNumber() || (c == '\'' && !current.isEmpty())) {
+            current += c.toLower();
+        } else {
+            flush();
+        }
+    }
+    flush();
+    return tokens;
+}
+
+void TranscriptJournal::indexRecord(quint32 id, const QString& username, const QString& text) {
+    std::set<QByteArray> terms;
+    for (auto& token : tokenize(text)) {
+        terms.insert(std::move(token));
+    }
+    terms.insert("@" + username.toLower().toUtf8());
+
+    for (const auto& term : terms) {
+        tailIndex[term].push_back(id);
+    }
+}
+
+std::vector<quint32> TranscriptJournal::postings(const QByteArray& term) {
+    std::vector<quint32> ids;
+
+    // On-disk part: binary search the sorted term table
+    if (indexMap) {
+        const auto* header = reinterpret_cast<const IndexHeader*>(indexMap);
+        const auto* terms = reinterpret_cast<const IndexTerm*>(indexMap + sizeof(IndexHeader));
+        auto termBytes = [this](const IndexTerm& entry) {
+            return QByteArray::fromRawData(reinterpret_cast<const char*>(indexMap + entry.termOffset),
+                                           static_cast<int>(entry.termLength));
+        };
+
+        const IndexTerm* end = terms + header->termCount;
+        const IndexTerm* found = std::lower_bound(terms, end, term,
+            [&termBytes](const IndexTerm& entry, const QByteArray& key) { return termBytes(entry) < key; });
+
+        if (found != end && termBytes(*found) == term) {
+            ids.reserve(found->postingCount);
+            const uchar* p = indexMap + found->postingOffset;
+            const uchar* stop = p + found->postingBytes;
+            quint32 id = 0;
+            while (p < stop) {
+                quint32 delta = 0;
+                int shift = 0;
+                while (p < stop) {
+                    const uchar byte = *p++;
+                    delta |= static_cast<quint32>(byte & 0x7f) << shift;
+                    shift += 7;
+                    if (!(byte & 0x80)) {
+                        break;
+                    }
+                }
+                id += delta;
+                ids.push_back(id);
+            }
+        }
+    }
+
+    // In-memory tail; its ids are all newer than the on-disk ones
+    auto tail = tailIndex.find(term);
+    if (tail != tailIndex.end()) {
+        ids.insert(ids.end(), tail->second.begin(), tail->second.end());
+    }
+    return ids;
+}
+
+std::vector<JournalEntry> TranscriptJournal::search(const QString& query, int limit) {
+    std::vector<JournalEntry> results;
+    if (!isOpen()) {
+        return results;
+    }
+
+    std::vector<QByteArray> terms;
+    for (const QString& word : query.split(' ', Qt::SkipEmptyParts)) {
+        if (word.startsWith('@') && word.size() > 1) {
+            terms.push_back(word.toLower().toUtf8());
+        } else {
+            for (auto& token : tokenize(word)) {
+                terms.push_back(std::move(token));
+            }
+        }
+    }
+    if (terms.empty()) {
+        return results;
+    }
+
+    // Intersect, rarest term first
+    std::vector<std::vector<quint32>> lists;
+    for (const auto& term : terms) {
+        lists.push_back(postings(term));
+        if (lists.back().empty()) {
+            return results;
+        }
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const auto& a, const auto& b) { return a.size() < b.size(); });
+
+    std::vector<quint32> matches = lists.front();
+    for (size_t i = 1; i < lists.size() && !matches.empty(); ++i) {
+        std::vector<quint32> next;
+        std::set_intersection(matches.begin(), matches.end(),
+                              lists[i].begin(), lists[i].end(),
+                              std::back_inserter(next));
+        matches.swap(next);
+    }
+
+    for (auto it = matches.rbegin(); it != matches.rend() && static_cast<int>(results.size()) < limit; ++it) {
+        results.push_back(entry(*it));
+    }
+    return results;
+}
+
+void TranscriptJournal::appendVarint(QByteArray& out, quint32 value) {
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+bool TranscriptJournal::loadIndex() {
+    indexFile.setFileName(directory + "/index.bin");
+    if (!indexFile.exists() || !indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    if (!remap(indexFile, indexMap, indexMapped) || indexMapped < static_cast<qint64>(sizeof(IndexHeader))) {
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const IndexHeader*>(indexMap);
+    const qint64 tableEnd = sizeof(IndexHeader) + static_cast<qint64>(header->termCount) * sizeof(IndexTerm);
+    if (std::memcmp(header->magic, "WCTI", 4) != 0 || header->version != INDEX_VERSION ||
+        header->recordCount > recordCount || tableEnd > indexMapped) {
+        qWarning() << "Transcript index is stale or damaged, rebuilding";
+        indexFile.unmap(indexMap);
+        indexMap = nullptr;
+        indexMapped = 0;
+        indexFile.close();
+        return false;
+    }
+
+    indexedCount = static_cast<quint32>(header->recordCount);
+    return true;
+}
+
+bool TranscriptJournal::writeIndex() {
+    // Merge the mapped index with the tail; every term's list is needed anyway
+    std::map<QByteArray, std::vector<quint32>> merged;
+    if (indexMap) {
+        const auto* header = reinterpret_cast<const IndexHeader*>(indexMap);
+        const auto* terms = reinterpret_cast<const IndexTerm*>(indexMap + sizeof(IndexHeader));
+        for (quint32 i = 0; i < header->termCount; ++i) {
+            QByteArray term(reinterpret_cast<const char*>(indexMap + terms[i].termOffset),
+                            static_cast<int>(terms[i].termLength));
+            merged[term] = postings(term);  // Includes the tail part
+        }
+    }
+    for (const auto& [term, ids] : tailIndex) {
+        if (merged.find(term) == merged.end()) {
+            merged[term] = ids;
+        }
+    }
+
+    // Layout: header, term table, term bytes, postings
+    QByteArray termBytes;
+    QByteArray postingBytes;
+    std::vector<IndexTerm> table;
+    table.reserve(merged.size());
+    for (const auto& [term, ids] : merged) {
+        IndexTerm entry = {};
+        entry.termOffset = static_cast<quint64>(termBytes.size());
+        entry.termLength = static_cast<quint32>(term.size());
+        entry.postingOffset = static_cast<quint64>(postingBytes.size());
+        entry.postingCount = static_cast<quint32>(ids.size());
+        termBytes.append(term);
+
+        quint32 previous = 0;
+        for (quint32 id : ids) {
+            appendVarint(postingBytes, id - previous);
+            previous = id;
+        }
+        entry.postingBytes = static_cast<quint32>(postingBytes.size() - entry.postingOffset);
+        table.push_back(entry);
+    }
+
+    const quint64 termBase = sizeof(IndexHeader) + table.size() * sizeof(IndexTerm);
+    const quint64 postingBase = termBase + static_cast<quint64>(termBytes.size());
+    for (auto& entry : table) {
+        entry.termOffset += termBase;
+        entry.postingOffset += postingBase;
+    }
+
+    IndexHeader header = {};
+    std::memcpy(header.magic, "WCTI", 4);
+    header.version = INDEX_VERSION;
+    header.recordCount = recordCount;
+    header.termCount = static_cast<quint32>(table.size());
+
+    QSaveFile out(directory + "/index.bin");
+    if (!out.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), static_cast<qint64>(table.size() * sizeof(IndexTerm)));
+    out.write(termBytes);
+    out.write(postingBytes);
+
+    // Swap in the new file and map it
+    if (indexMap) {
+        indexFile.unmap(indexMap);
+        indexMap = nullptr;
+        indexMapped = 0;
+    }
+    indexFile.close();
+    if (!out.commit()) {
+        qWarning() << "Failed to write transcript index";
+        loadIndex();
+        return false;
+    }
+
+    tailIndex.clear();
+    indexedCount = recordCount;
+    return loadIndex();
+}
+
+} // namespace storage
+} // namespace whisper_client
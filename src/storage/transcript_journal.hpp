@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QByteArray>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+namespace whisper_client {
+namespace storage {
+
+struct JournalEntry {
+    quint32 id = 0;
+    QDateTime timestamp;
+    QString username;
+    QString text;
+};
+
+// Append-only transcript history on disk.
+//
+//   records.bin  fixed-size records (timestamp and string offsets)
+//   strings.bin  UTF-8 arena holding usernames and texts
+//   index.bin    inverted index: sorted term table plus delta/varint posting
+//                lists, covering the first N records
+//
+// Records and the index are memory-mapped for reads. Records appended since
+// the index was written are indexed in memory and merged into index.bin on
+// close or once the in-memory tail grows large.
+class TranscriptJournal {
+public:
+    TranscriptJournal();
+    ~TranscriptJournal();
+
+    TranscriptJournal(const TranscriptJournal&) = delete;
+    TranscriptJournal& operator=(const TranscriptJournal&) = delete;
+
+    bool open(const QString& directory);
+    void close();
+    bool isOpen() const { return recordsFile.isOpen(); }
+
+    bool append(const QString& username, const QString& text, const QDateTime& timestamp);
+    quint32 size() const { return recordCount; }
+    JournalEntry entry(quint32 id);
+
+    // Every word in the query must match; "@name" restricts to one user.
+    // Newest first.
+    std::vector<JournalEntry> search(const QString& query, int limit = 50);
+
+    static std::vector<QByteArray> tokenize(const QString& text);
+
+private:
+#pragma pack(push, 1)
+    struct Record {
+        qint64 timestampMs;
+        quint64 textOffset;
+        quint64 userOffset;
+        quint32 textLength;
+        quint32 userLength;
+    };
+
+    struct IndexHeader {
+        char magic[4];
+        quint32 version;
+        quint64 recordCount;   // Records covered by this index
+        quint32 termCount;
+        quint32 reserved;
+    };
+
+    struct IndexTerm {
+        quint64 termOffset;
+        quint64 postingOffset;
+        quint32 termLength;
+        quint32 postingCount;
+        quint32 postingBytes;
+        quint32 reserved;
+    };
+#pragma pack(pop)
+
+    const Record* recordAt(quint32 id);
+    QString stringAt(quint64 offset, quint32 length);
+    bool remap(QFile& file, uchar*& mapping, qint64& mappedSize);
+
+    std::vector<quint32> postings(const QByteArray& term);
+    void indexRecord(quint32 id, const QString& username, const QString& text);
+    bool loadIndex();
+    bool writeIndex();
+
+    static void appendVarint(QByteArray& out, quint32 value);
+
+    QString directory;
+    QFile recordsFile;
+    QFile stringsFile;
+    QFile indexFile;
+
+    uchar* recordsMap;
+    qint64 recordsMapped;
+    uchar* stringsMap;
+    qint64 stringsMapped;
+    uchar* indexMap;
+    qint64 indexMapped;
+
+    quint32 recordCount;
+    quint64 stringsSize;
+
+    // Postings for records the on-disk index does not cover yet
+    quint32 indexedCount;
+    std::map<QByteArray, std::vector<quint32>> tailIndex;
+
+    static constexpr quint32 INDEX_VERSION = 1;
+    static constexpr quint32 MAX_TAIL_RECORDS = 4096;
+};
+
+} // namespace storage
+} // namespace whisper_client
@@ -5,17 +5,33 @@
 #include "network/websocket_client.hpp"
 #include "audio/audio_capture.hpp"
 #include "audio/audio_processor.hpp"
+#include "audio/transcription_worker.hpp"
 #include "audio/model_manager.hpp"
+#include "audio/model_governor.hpp"
 #include "input/hotkey_manager.hpp"
+#include "storage/transcript_journal.hpp"
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 #include <QtGui/QCloseEvent>
 #include <QtGui/QIcon>
 #include <QtCore/QDebug>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
 
 namespace whisper_client {
 namespace ui {
 
+namespace {
+
+constexpr size_t SAMPLES_PER_SECOND = 16000;
+constexpr size_t SAMPLES_PER_FRAME = 160;           // Whisper's 10 ms timestamp unit
+constexpr size_t MIN_PARTIAL_SAMPLES = SAMPLES_PER_SECOND / 2;
+constexpr double COMMIT_AFTER_SECONDS = 10.0;        // Window length before segments are committed
+constexpr int PROGRESS_INTERVAL_MS = 100;
+constexpr int HISTORY_RESULTS = 20;
+
+} // namespace
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , settingsFrame(std::make_unique<SettingsFrame>(this))
@@ -24,7 +40,16 @@ MainWindow::MainWindow(QWidget *parent)
     , wsClient(std::make_unique<network::WebSocketClient>(this))
     , audioCapture(std::make_unique<audio::AudioCapture>())
     , audioProcessor(std::make_unique<audio::AudioProcessor>())
+    , transcriptionWorker(std::make_unique<audio::TranscriptionWorker>(audioProcessor.get()))
+    , modelGovernor(std::make_unique<audio::ModelGovernor>(audioProcessor->getModelManager()))
     , hotkeyManager(std::make_unique<input::HotkeyManager>(this))
+    , transcriptJournal(std::make_unique<storage::TranscriptJournal>())
+    , partialTimer(new QTimer(this))
+    , committedSamples(0)
+    , transcriptSequence(0)
+    , progressTimer(new QTimer(this))
+    , pendingBytesReceived(0)
+    , pendingBytesTotal(0)
 {
     setupUi();
     loadConfig();
@@ -87,6 +112,16 @@ void MainWindow::saveConfig() {
 void MainWindow::initializeComponents() {
     appendSystemMessage("Initializing components...");
 
+    // Bound the transcript history
+    transcriptFrame->setMaxMessages(settingsFrame->getTranscriptMaxLines());
+
+    // Every published transcript is also kept on disk and searchable
+    if (!transcriptJournal->open(QCoreApplication::applicationDirPath() + "/history")) {
+        appendSystemMessage("Failed to open transcript history");
+    }
+    connect(transcriptFrame.get(), &TranscriptFrame::historySearchRequested,
+            this, &MainWindow::searchHistory);
+
     // Set up model manager connections
     setupModelManager();
 
@@ -99,31 +134,158 @@ void MainWindow::initializeComponents() {
         updateRecordingStatus(false);
     });
 
-    // Initialize audio processor callbacks
-    audioProcessor->setProcessingStartCallback([this]() {
-        updateProcessingStatus(true);
-    });
-    
-    audioProcessor->setProcessingEndCallback([this]() {
-        updateProcessingStatus(false);
+    // Build the mel spectrogram during capture, sized for the loaded model
+    if (audioProcessor->isModelLoaded()) {
+        audioCapture->setMelPrecompute(audioProcessor->getMelCount());
+    }
+    connect(audioProcessor.get(), &audio::AudioProcessor::modelReady,
+            this, [this]() {
+                audioCapture->setMelPrecompute(audioProcessor->getMelCount());
+            });
+
+    // Trim leading and trailing silence before decoding
+    audioCapture->setVoiceActivityDetection(settingsFrame->isVoiceActivityDetectionEnabled());
+
+    // Model switches load in the background; keep recent models resident
+    audioProcessor->setMaxResidentModels(settingsFrame->getResidentModels());
+    connect(audioProcessor.get(), &audio::AudioProcessor::modelLoadFailed,
+            this, [this](const QString& modelPath) {
+                appendSystemMessage(QString("Failed to load model %1").arg(modelPath));
+            });
+
+    // Real-time factor feedback: show it, and step model tiers if enabled
+    connect(transcriptionWorker.get(), &audio::TranscriptionWorker::utteranceDecoded,
+            modelGovernor.get(), &audio::ModelGovernor::recordUtterance);
+    connect(modelGovernor.get(), &audio::ModelGovernor::realTimeFactorChanged,
+            statusFrame.get(), &StatusFrame::updateModelStatus);
+    // Queued: a switch that fails verification reports from inside setModel,
+    // and the rollback must not run in the middle of the governor's step
+    connect(audioProcessor.get(), &audio::AudioProcessor::modelLoadFailed,
+            modelGovernor.get(), &audio::ModelGovernor::modelLoadFailed, Qt::QueuedConnection);
+    connect(modelGovernor.get(), &audio::ModelGovernor::stepReverted,
+            this, [this](const QString& failedModel, const QString& restoredModel) {
+                statusFrame->updateModelStatus(restoredModel, 0.0);
+                appendSystemMessage(QString("Model %1 failed to load, staying on %2")
+                    .arg(failedModel, restoredModel));
+            });
+    connect(modelGovernor.get(), &audio::ModelGovernor::modelStepped,
+            this, [this](const QString& fromModel, const QString& toModel, double realTimeFactor) {
+                statusFrame->updateModelStatus(toModel, 0.0);
+                const bool slow = realTimeFactor > audio::ModelGovernor::STEP_DOWN_RTF;
+                appendSystemMessage(QString("Decode time %1 %2x audio length (RTF %3), switching model %4 -> %5")
+                    .arg(slow ? "above" : "below")
+                    .arg(slow ? audio::ModelGovernor::STEP_DOWN_RTF : audio::ModelGovernor::STEP_UP_RTF)
+                    .arg(realTimeFactor, 0, 'f', 2)
+                    .arg(fromModel, toModel));
+            });
+    modelGovernor->setEnabled(settingsFrame->isModelGovernorEnabled());
+    statusFrame->updateModelStatus(audioProcessor->getModelManager()->getCurrentModel(), 0.0);
+
+    // Keep the input stream warm if requested so the pre-roll covers the press
+    audioCapture->setCompactCapture(settingsFrame->isCompactCaptureEnabled());
+    audioCapture->setPreRollMs(static_cast<unsigned int>(settingsFrame->getPreRollMs()));
+    if (settingsFrame->isWarmStreamEnabled() && !audioCapture->setWarmStreamEnabled(true)) {
+        appendSystemMessage("Failed to open warm input stream");
+    }
+
+    // Hands-free capture: the endpointer runs on the capture drain thread and
+    // queues each utterance for transcription as soon as its trailing silence
+    // is detected
+    audioCapture->setEndpointTimeoutMs(static_cast<unsigned int>(settingsFrame->getEndpointTimeoutMs()));
+    audioCapture->setUtteranceCallback([this](audio::UtteranceBuffer utterance) {
+        if (utterance.hasSpeech()) {
+            transcriptionWorker->enqueue(std::move(utterance));
+        }
     });
 
+    // Transcription runs on the worker thread; each segment comes back queued
+    // as soon as whisper finalises it
+    connect(transcriptionWorker.get(), &audio::TranscriptionWorker::processingChanged,
+            this, &MainWindow::updateProcessingStatus);
+    connect(transcriptionWorker.get(), &audio::TranscriptionWorker::segmentReady,
+            this, [this](const QString& text) {
+                publishTranscript(text);
+            });
+    connect(transcriptionWorker.get(), &audio::TranscriptionWorker::partialReady,
+            this, &MainWindow::onPartialReady);
+    connect(transcriptionWorker.get(), &audio::TranscriptionWorker::utterancesDropped,
+            this, [this](int count) {
+                appendSystemMessage(QString("Dropped %1 pending utterance(s)").arg(count));
+            });
+    transcriptionWorker->setBusyPolicy(settingsFrame->getBusyPolicy());
+    audioProcessor->setAdaptiveContext(settingsFrame->isAdaptiveContextEnabled());
+    if (!transcriptionWorker->setCpuAffinity(settingsFrame->getInferenceAffinity())) {
+        appendSystemMessage("Invalid CPU core list, inference threads are not pinned");
+    }
+    transcriptionWorker->start();
+
+    // Thread count: manual override, else the calibrated value, else calibrate
+    // once the model is ready and persist the result
+    connect(transcriptionWorker.get(), &audio::TranscriptionWorker::calibrationFinished,
+            this, [this](int threads) {
+                settingsFrame->setCalibratedThreads(threads);
+                if (settingsFrame->getWhisperThreads() > 0) {
+                    audioProcessor->setThreadCount(settingsFrame->getWhisperThreads());
+                }
+                appendSystemMessage(QString("Calibrated whisper threads: %1").arg(threads));
+            });
+    connect(settingsFrame.get(), &SettingsFrame::calibrationRequested,
+            this, [this]() {
+                appendSystemMessage("Calibrating whisper threads...");
+                transcriptionWorker->requestCalibration();
+            });
+
+    if (settingsFrame->getWhisperThreads() > 0) {
+        audioProcessor->setThreadCount(settingsFrame->getWhisperThreads());
+    } else if (settingsFrame->getCalibratedThreads() > 0) {
+        audioProcessor->setThreadCount(settingsFrame->getCalibratedThreads());
+    } else if (audioProcessor->isModelLoaded()) {
+        transcriptionWorker->requestCalibration();
+    } else {
+        connect(audioProcessor.get(), &audio::AudioProcessor::modelReady,
+                this, [this]() {
+                    if (settingsFrame->getWhisperThreads() == 0 && settingsFrame->getCalibratedThreads() == 0) {
+                        transcriptionWorker->requestCalibration();
+                    }
+                }, Qt::SingleShotConnection);
+    }
+
+    // Re-decode the growing recording periodically while the hotkey is held
+    partialTimer->setInterval(settingsFrame->getPartialIntervalMs());
+    connect(partialTimer, &QTimer::timeout, this, &MainWindow::submitPartial);
+
     // Initialize hotkey manager
     connect(hotkeyManager.get(), &input::HotkeyManager::recordingStarted,
             [this]() {
                 audioCapture->startRecording();
+                committedSamples = 0;
+                if (settingsFrame->isStreamingPartialsEnabled() && audioCapture->isRecording()) {
+                    partialTimer->start();
+                }
             });
             
     connect(hotkeyManager.get(), &input::HotkeyManager::recordingStopped,
             [this]() {
+                partialTimer->stop();
+                transcriptionWorker->discardPartials();
+                transcriptFrame->clearProvisionalText();
+
                 if (audioCapture->isRecording()) {
-                    auto audioData = audioCapture->stopRecording();
-                    if (!audioData.empty()) {
-                        processAudioData(audioData);
+                    auto utterance = audioCapture->stopRecording();
+
+                    // Only the part not yet committed by partials is decoded;
+                    // the committed audio stays in the buffer as context
+                    utterance.setDecodeOffsetMs(static_cast<int>(committedSamples * 1000 / SAMPLES_PER_SECOND));
+                    if (utterance.size() > committedSamples + SAMPLES_PER_FRAME) {
+                        processAudioData(std::move(utterance));
                     }
                 }
+                committedSamples = 0;
             });
             
+    connect(hotkeyManager.get(), &input::HotkeyManager::listeningChanged,
+            this, &MainWindow::setContinuousListening);
+
     connect(hotkeyManager.get(), &input::HotkeyManager::actionTriggered,
             [this](const QString& action) {
                 if (wsClient && wsClient->isConnected()) {
@@ -148,7 +310,7 @@ void MainWindow::initializeComponents() {
 
     // Set initial hotkeys from settings
     hotkeyManager->setRecordingHotkey(settingsFrame->getPushToTalkKey());
-    hotkeyManager->setRecordingMode(settingsFrame->isToggleModeEnabled() ? "toggle" : "push");
+    hotkeyManager->setRecordingMode(settingsFrame->getRecordingMode());
     
     // Set action hotkeys
     const QStringList actions = {"tts", "follows", "subs", "gifts"};
@@ -167,6 +329,9 @@ void MainWindow::initializeComponents() {
     // Initialize with disconnected state
     updateWebSocketStatus(false);
     updateRecordingStatus(false);
+    if (settingsFrame->getRecordingMode() == "continuous") {
+        setContinuousListening(true);
+    }
     updateProcessingStatus(false);
     updateBotStatus(false);
     updateMetrics(0, 0, 0, 0);
@@ -177,15 +342,39 @@ void MainWindow::initializeComponents() {
 void MainWindow::setupModelManager() {
     auto modelManager = audioProcessor->getModelManager();
     if (modelManager) {
+        // Progress arrives far more often than it is worth repainting; keep
+        // the latest value and show it at most every PROGRESS_INTERVAL_MS
+        progressTimer->setSingleShot(true);
+        progressTimer->setInterval(PROGRESS_INTERVAL_MS);
+        connect(progressTimer, &QTimer::timeout, this, [this]() {
+            statusFrame->updateDownloadProgress(pendingBytesReceived, pendingBytesTotal);
+        });
         connect(modelManager, &audio::ModelManager::downloadProgress,
-                [this](qint64 received, qint64 total) {
-                    QString progress = QString("Downloading model: %1%")
-                        .arg((received * 100) / total);
-                    appendSystemMessage(progress);
+                this, [this](qint64 received, qint64 total) {
+                    pendingBytesReceived = received;
+                    pendingBytesTotal = total;
+                    if (!progressTimer->isActive()) {
+                        progressTimer->start();
+                    }
+                });
+
+        connect(modelManager, &audio::ModelManager::verificationFinished,
+                this, [this](const QString& modelName, bool valid) {
+                    appendSystemMessage(QString("Model %1 verification %2")
+                        .arg(modelName)
+                        .arg(valid ? "passed" : "failed"));
+                });
+
+        connect(settingsFrame.get(), &SettingsFrame::modelVerifyRequested,
+                this, [this, modelManager]() {
+                    appendSystemMessage("Verifying model in the background...");
+                    modelManager->reverifyModel(modelManager->getCurrentModel());
                 });
 
         connect(modelManager, &audio::ModelManager::downloadComplete,
-                [this](bool success, const QString& message) {
+                this, [this](bool success, const QString& message) {
+                    progressTimer->stop();
+                    statusFrame->hideDownloadProgress();
                     appendSystemMessage(QString("Model download %1: %2")
                         .arg(success ? "completed" : "failed")
                         .arg(message));
@@ -193,31 +382,123 @@ void MainWindow::setupModelManager() {
     }
 }
 
-void MainWindow::processAudioData(const std::vector<float>& audioData) {
-    if (audioData.empty()) {
+void MainWindow::setContinuousListening(bool listening) {
+    if (!audioCapture->setContinuousMode(listening)) {
+        appendSystemMessage("Failed to start continuous listening");
+        updateRecordingStatus(false);
         return;
     }
+    updateRecordingStatus(listening);
+    appendSystemMessage(listening ? "Listening hands-free" : "Listening paused");
+}
 
-    // Process the audio and get transcription
-    audio::TranscriptionResult result = audioProcessor->processAudio(audioData);
-    
-    if (!result.text.isEmpty()) {
+void MainWindow::processAudioData(audio::UtteranceBuffer utterance) {
+    if (utterance.empty()) {
+        return;
+    }
+
+    // The voice activity detector found nothing worth decoding
+    if (!utterance.hasSpeech()) {
+        appendSystemMessage("No speech detected");
+        return;
+    }
+
+    // Hand off to the worker; the text comes back segment by segment through
+    // segmentReady as whisper finalises it
+    transcriptionWorker->enqueue(std::move(utterance));
+}
+
+void MainWindow::submitPartial() {
+    if (!audioCapture->isRecording()) {
+        partialTimer->stop();
+        return;
+    }
+
+    auto window = audioCapture->snapshotRecording(committedSamples);
+    if (window.size() >= MIN_PARTIAL_SAMPLES) {
+        transcriptionWorker->submitPartial(std::move(window), static_cast<qint64>(committedSamples));
+    }
+}
+
+void MainWindow::onPartialReady(const audio::TranscriptionResult& result, qint64 windowStart) {
+    // Ignore windows that finished after release or predate the last commit
+    if (!audioCapture->isRecording() || windowStart != static_cast<qint64>(committedSamples)) {
+        return;
+    }
+
+    QString provisional = result.text;
+
+    // Once the window gets long, everything but the last segment is stable
+    // enough to publish; later windows start at the last segment
+    const size_t count = result.segmentTexts.size();
+    if (count >= 2 && count == result.segments.size() &&
+        result.segments.back().second >= COMMIT_AFTER_SECONDS) {
+        QString committed;
+        for (size_t i = 0; i + 1 < count; ++i) {
+            committed += result.segmentTexts[i] + " ";
+        }
+        publishTranscript(committed.trimmed());
+
+        const size_t frames = static_cast<size_t>(result.segments.back().first * 100.0 + 0.5);
+        committedSamples += frames * SAMPLES_PER_FRAME;
+        provisional = result.segmentTexts.back();
+    }
+
+    publishProvisional(provisional);
+}
+
+void MainWindow::publishTranscript(const QString& text) {
+    if (!text.isEmpty()) {
         // Send transcript to WebSocket if connected
         if (wsClient && wsClient->isConnected()) {
             wsClient->sendTranscript(
                 settingsFrame->getSelectedUser(),
-                result.text
+                text,
+                transcriptSequence,
+                true
             );
         }
+        ++transcriptSequence;
+
+        transcriptJournal->append(settingsFrame->getSelectedUser(), text, QDateTime::currentDateTime());
         
         // Display transcript
         appendTranscript(
             settingsFrame->getSelectedUser(),
-            result.text
+            text
+        );
+    }
+}
+
+void MainWindow::publishProvisional(const QString& text) {
+    transcriptFrame->setProvisionalText(settingsFrame->getSelectedUser(), text);
+
+    if (!text.trimmed().isEmpty() && wsClient && wsClient->isConnected()) {
+        wsClient->sendTranscript(
+            settingsFrame->getSelectedUser(),
+            text.trimmed(),
+            transcriptSequence,
+            false
         );
     }
 }
 
+void MainWindow::searchHistory(const QString& query) {
+    QElapsedTimer timer;
+    timer.start();
+    const auto results = transcriptJournal->search(query, HISTORY_RESULTS);
+
+    appendSystemMessage(QString("History search \"%1\": %2 result(s) in %3 ms")
+        .arg(query)
+        .arg(results.size())
+        .arg(timer.elapsed()));
+    for (const auto& entry : results) {
+        appendSystemMessage(QString("%1 %2: %3")
+            .arg(entry.timestamp.toString("yyyy-MM-dd hh:mm"))
+            .arg(entry.username, entry.text));
+    }
+}
+
 void MainWindow::updateWebSocketStatus(bool connected) {
     statusFrame->updateWebSocketStatus(connected);
     appendSystemMessage(connected ? "WebSocket connected." : "WebSocket disconnected.");
@@ -295,11 +576,20 @@ void MainWindow::onClosing() {
             hotkeyManager->stop();
         }
 
-        // Stop recording if active
+        // Stop recording if active; the endpointer must not hand over more work
+        partialTimer->stop();
+        if (audioCapture) {
+            audioCapture->setContinuousMode(false);
+        }
         if (audioCapture && audioCapture->isRecording()) {
             audioCapture->stopRecording();
         }
 
+        // Let any in-flight transcription finish, drop queued ones
+        if (transcriptionWorker) {
+            transcriptionWorker->stop();
+        }
+
         // Clean up audio processor
         if (audioProcessor) {
             audioProcessor->cleanup();
@@ -310,6 +600,11 @@ void MainWindow::onClosing() {
             wsClient->disconnect();
         }
 
+        // Flush the transcript index
+        if (transcriptJournal) {
+            transcriptJournal->close();
+        }
+
         // Save configuration
         saveConfig();
 
@@ -3,6 +3,7 @@
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QLabel>
+#include <QtCore/QTimer>
 #include <memory>
 
 namespace whisper_client {
@@ -14,12 +15,20 @@ class WebSocketClient;
 namespace audio {
 class AudioCapture;
 class AudioProcessor;
+class TranscriptionWorker;
+class ModelGovernor;
+class UtteranceBuffer;
+struct TranscriptionResult;
 }
 
 namespace input {
 class HotkeyManager;
 }
 
+namespace storage {
+class TranscriptJournal;
+}
+
 namespace ui {
 
 class SettingsFrame;
@@ -59,9 +68,15 @@ protected:
 
 private slots:
     void onClosing();
-    void processAudioData(const std::vector<float>& audioData);
 
 private:
+    void setContinuousListening(bool listening);
+    void processAudioData(audio::UtteranceBuffer utterance);
+    void onPartialReady(const audio::TranscriptionResult& result, qint64 windowStart);
+    void submitPartial();
+    void publishTranscript(const QString& text);
+    void publishProvisional(const QString& text);
+    void searchHistory(const QString& query);
     void setupUi();
     void loadConfig();
     void saveConfig();
@@ -77,7 +92,23 @@ private:
     std::unique_ptr<network::WebSocketClient> wsClient;
     std::unique_ptr<audio::AudioCapture> audioCapture;
     std::unique_ptr<audio::AudioProcessor> audioProcessor;
+    std::unique_ptr<audio::TranscriptionWorker> transcriptionWorker;
+    std::unique_ptr<audio::ModelGovernor> modelGovernor;
     std::unique_ptr<input::HotkeyManager> hotkeyManager;
+    std::unique_ptr<storage::TranscriptJournal> transcriptJournal;
+
+    // Streaming partials: audio before committedSamples has already been
+    // published; partial windows and the final decode start there
+    QTimer* partialTimer;
+    size_t committedSamples;
+
+    // Sequence number of the next final transcript sent over the WebSocket
+    int transcriptSequence;
+
+    // Latest model download progress, shown when progressTimer fires
+    QTimer* progressTimer;
+    qint64 pendingBytesReceived;
+    qint64 pendingBytesTotal;
     
     // UI Layout
     QWidget *centralWidget;
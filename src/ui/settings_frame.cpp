@@ -33,6 +33,7 @@ void SettingsFrame::setupUi() {
     createUserSection();
     createWebSocketSection();
     createHotkeySection();
+    createTranscriptionSection();
     createActionHotkeysSection();
 
     // Save button
@@ -101,20 +102,145 @@ void SettingsFrame::createWebSocketSection() {
 
 void SettingsFrame::createHotkeySection() {
     auto* hotkeyGroup = new QGroupBox("Push to Talk", this);
-    auto* hotkeyLayout = new QHBoxLayout(hotkeyGroup);
+    auto* groupLayout = new QVBoxLayout(hotkeyGroup);
+    auto* hotkeyLayout = new QHBoxLayout();
     
     hotkeyEdit = new QLineEdit(this);
     hotkeyEdit->setReadOnly(true);
     hotkeyButton = new QPushButton("Set Key", this);
-    recordingModeSwitch = new QCheckBox("Toggle Mode", this);
+    // Continuous listens hands-free; the hotkey then pauses and resumes
+    recordingModeComboBox = new QComboBox(this);
+    recordingModeComboBox->addItem("Push", "push");
+    recordingModeComboBox->addItem("Toggle", "toggle");
+    recordingModeComboBox->addItem("Continuous", "continuous");
     
     hotkeyLayout->addWidget(hotkeyEdit);
     hotkeyLayout->addWidget(hotkeyButton);
-    hotkeyLayout->addWidget(recordingModeSwitch);
+    hotkeyLayout->addWidget(recordingModeComboBox);
+    groupLayout->addLayout(hotkeyLayout);
+
+    // Warm stream keeps the mic open so speech before the press is not lost
+    auto* captureLayout = new QHBoxLayout();
+    warmStreamCheckBox = new QCheckBox("Keep Mic Open", this);
+    preRollSpinBox = new QSpinBox(this);
+    preRollSpinBox->setRange(0, 2000);
+    preRollSpinBox->setSingleStep(50);
+    preRollSpinBox->setSuffix(" ms");
+    preRollSpinBox->setValue(300);
+    preRollSpinBox->setEnabled(false);
+
+    captureLayout->addWidget(warmStreamCheckBox);
+    captureLayout->addWidget(new QLabel("Pre-roll:", this));
+    captureLayout->addWidget(preRollSpinBox);
+    captureLayout->addStretch();
+    groupLayout->addLayout(captureLayout);
+
+    // Trailing silence that ends an utterance in continuous mode
+    auto* endpointLayout = new QHBoxLayout();
+    endpointTimeoutSpinBox = new QSpinBox(this);
+    endpointTimeoutSpinBox->setRange(200, 3000);
+    endpointTimeoutSpinBox->setSingleStep(100);
+    endpointTimeoutSpinBox->setSuffix(" ms");
+    endpointTimeoutSpinBox->setValue(700);
+    endpointTimeoutSpinBox->setEnabled(false);
+
+    endpointLayout->addWidget(new QLabel("End of Speech After:", this));
+    endpointLayout->addWidget(endpointTimeoutSpinBox);
+
+    // Half the buffer memory; takes effect when the input is next opened
+    compactCaptureCheckBox = new QCheckBox("16-bit Capture", this);
+    endpointLayout->addWidget(compactCaptureCheckBox);
+    endpointLayout->addStretch();
+    groupLayout->addLayout(endpointLayout);
     
     mainLayout->addWidget(hotkeyGroup);
 }
 
+void SettingsFrame::createTranscriptionSection() {
+    auto* transcriptionGroup = new QGroupBox("Transcription", this);
+    auto* transcriptionLayout = new QGridLayout(transcriptionGroup);
+
+    // What to do with a new utterance while the previous one is decoding
+    busyPolicyComboBox = new QComboBox(this);
+    busyPolicyComboBox->addItem("Queue", "queue");
+    busyPolicyComboBox->addItem("Drop Oldest", "drop_oldest");
+    busyPolicyComboBox->addItem("Preempt", "preempt");
+
+    transcriptionLayout->addWidget(new QLabel("When Busy:", this), 0, 0);
+    transcriptionLayout->addWidget(busyPolicyComboBox, 0, 1);
+
+    // Inference threads; "Auto" uses the calibrated value
+    threadsSpinBox = new QSpinBox(this);
+    threadsSpinBox->setRange(0, 64);
+    threadsSpinBox->setSpecialValueText("Auto");
+    calibrateButton = new QPushButton("Calibrate", this);
+
+    transcriptionLayout->addWidget(new QLabel("Threads:", this), 1, 0);
+    transcriptionLayout->addWidget(threadsSpinBox, 1, 1);
+    transcriptionLayout->addWidget(calibrateButton, 1, 2);
+
+    connect(calibrateButton, &QPushButton::clicked, this, &SettingsFrame::calibrationRequested);
+
+    // Optional pinning of the inference threads, applied on next start
+    affinityEdit = new QLineEdit(this);
+    affinityEdit->setPlaceholderText("Any (e.g. 0-7)");
+
+    transcriptionLayout->addWidget(new QLabel("CPU Cores:", this), 2, 0);
+    transcriptionLayout->addWidget(affinityEdit, 2, 1);
+
+    // Shrinks the encoder window for short push-to-talk clips
+    adaptiveContextCheckBox = new QCheckBox("Short-Clip Fast Path", this);
+    transcriptionLayout->addWidget(adaptiveContextCheckBox, 3, 0, 1, 2);
+
+    // Skips leading and trailing silence, and clips with no speech at all
+    vadCheckBox = new QCheckBox("Trim Silence", this);
+    vadCheckBox->setChecked(true);
+    transcriptionLayout->addWidget(vadCheckBox, 3, 2);
+
+    // Provisional text while the hotkey is still held
+    streamingPartialsCheckBox = new QCheckBox("Streaming Partials", this);
+    partialIntervalSpinBox = new QSpinBox(this);
+    partialIntervalSpinBox->setRange(200, 5000);
+    partialIntervalSpinBox->setSingleStep(100);
+    partialIntervalSpinBox->setSuffix(" ms");
+    partialIntervalSpinBox->setValue(500);
+    partialIntervalSpinBox->setEnabled(false);
+
+    transcriptionLayout->addWidget(streamingPartialsCheckBox, 4, 0);
+    transcriptionLayout->addWidget(partialIntervalSpinBox, 4, 1);
+
+    connect(streamingPartialsCheckBox, &QCheckBox::toggled, partialIntervalSpinBox, &QSpinBox::setEnabled);
+
+    // Models kept loaded for instant switching; each costs its full size in RAM
+    residentModelsSpinBox = new QSpinBox(this);
+    residentModelsSpinBox->setRange(1, 4);
+    residentModelsSpinBox->setValue(2);
+
+    transcriptionLayout->addWidget(new QLabel("Resident Models:", this), 5, 0);
+    transcriptionLayout->addWidget(residentModelsSpinBox, 5, 1);
+
+    // Step to a faster model when transcription falls behind real time
+    modelGovernorCheckBox = new QCheckBox("Adapt Model To Load", this);
+    transcriptionLayout->addWidget(modelGovernorCheckBox, 6, 0, 1, 2);
+
+    // Full rehash of the model file, bypassing the verification manifest
+    verifyModelButton = new QPushButton("Verify Model", this);
+    transcriptionLayout->addWidget(verifyModelButton, 6, 2);
+
+    connect(verifyModelButton, &QPushButton::clicked, this, &SettingsFrame::modelVerifyRequested);
+
+    // Transcript lines kept on screen; older ones are dropped
+    historyLinesSpinBox = new QSpinBox(this);
+    historyLinesSpinBox->setRange(100, 100000);
+    historyLinesSpinBox->setSingleStep(500);
+    historyLinesSpinBox->setValue(5000);
+
+    transcriptionLayout->addWidget(new QLabel("History Lines:", this), 7, 0);
+    transcriptionLayout->addWidget(historyLinesSpinBox, 7, 1);
+
+    mainLayout->addWidget(transcriptionGroup);
+}
+
 void SettingsFrame::createActionHotkeysSection() {
     auto* actionGroup = new QGroupBox("Twitch Action Hotkeys", this);
     auto* actionLayout = new QGridLayout(actionGroup);
@@ -149,7 +275,9 @@ void SettingsFrame::createActionHotkeysSection() {
 void SettingsFrame::setupConnections() {
     connect(wsEnabledCheckBox, &QCheckBox::toggled, this, &SettingsFrame::onWebSocketToggled);
     connect(hotkeyButton, &QPushButton::clicked, this, &SettingsFrame::onSetHotkeyClicked);
-    connect(recordingModeSwitch, &QCheckBox::toggled, this, &SettingsFrame::onRecordingModeChanged);
+    connect(recordingModeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &SettingsFrame::onRecordingModeChanged);
+    connect(warmStreamCheckBox, &QCheckBox::toggled, preRollSpinBox, &QSpinBox::setEnabled);
     connect(saveButton, &QPushButton::clicked, this, &SettingsFrame::saveSettings);
     connect(userComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &SettingsFrame::onUserSelectionChanged);
@@ -228,7 +356,29 @@ void SettingsFrame::loadSettings() {
         
         // Load push-to-talk settings
         hotkeyEdit->setText(config.value("push_to_talk_key", "f5").toString());
-        recordingModeSwitch->setChecked(config.value("recording_mode", "push").toString() == "toggle");
+        int modeIndex = recordingModeComboBox->findData(config.value("recording_mode", "push").toString());
+        if (modeIndex >= 0) {
+            recordingModeComboBox->setCurrentIndex(modeIndex);
+        }
+        endpointTimeoutSpinBox->setValue(config.value("endpoint_timeout_ms", 700).toInt());
+        warmStreamCheckBox->setChecked(config.value("warm_stream", false).toBool());
+        preRollSpinBox->setValue(config.value("pre_roll_ms", 300).toInt());
+        compactCaptureCheckBox->setChecked(config.value("capture_int16", false).toBool());
+
+        // Load transcription settings
+        int policyIndex = busyPolicyComboBox->findData(config.value("busy_policy", "queue").toString());
+        if (policyIndex >= 0) {
+            busyPolicyComboBox->setCurrentIndex(policyIndex);
+        }
+        threadsSpinBox->setValue(config.value("whisper_threads", 0).toInt());
+        affinityEdit->setText(config.value("inference_cpu_affinity").toString());
+        adaptiveContextCheckBox->setChecked(config.value("adaptive_audio_ctx", false).toBool());
+        vadCheckBox->setChecked(config.value("vad_enabled", true).toBool());
+        streamingPartialsCheckBox->setChecked(config.value("streaming_partials", false).toBool());
+        partialIntervalSpinBox->setValue(config.value("partial_interval_ms", 500).toInt());
+        residentModelsSpinBox->setValue(config.value("resident_models", 2).toInt());
+        modelGovernorCheckBox->setChecked(config.value("model_governor", false).toBool());
+        historyLinesSpinBox->setValue(config.value("transcript_max_lines", 5000).toInt());
         
         // Load action hotkeys
         for (auto &hotkey : actionHotkeys) {
@@ -256,7 +406,21 @@ void SettingsFrame::saveSettings() {
     config["ws_ip"] = wsIpEdit->text();
     config["ws_port"] = wsPortEdit->text();
     config["push_to_talk_key"] = hotkeyEdit->text();
-    config["recording_mode"] = recordingModeSwitch->isChecked() ? "toggle" : "push";
+    config["recording_mode"] = getRecordingMode();
+    config["endpoint_timeout_ms"] = endpointTimeoutSpinBox->value();
+    config["warm_stream"] = warmStreamCheckBox->isChecked();
+    config["pre_roll_ms"] = preRollSpinBox->value();
+    config["capture_int16"] = compactCaptureCheckBox->isChecked();
+    config["busy_policy"] = busyPolicyComboBox->currentData().toString();
+    config["whisper_threads"] = threadsSpinBox->value();
+    config["inference_cpu_affinity"] = affinityEdit->text().trimmed();
+    config["adaptive_audio_ctx"] = adaptiveContextCheckBox->isChecked();
+    config["vad_enabled"] = vadCheckBox->isChecked();
+    config["streaming_partials"] = streamingPartialsCheckBox->isChecked();
+    config["partial_interval_ms"] = partialIntervalSpinBox->value();
+    config["resident_models"] = residentModelsSpinBox->value();
+    config["model_governor"] = modelGovernorCheckBox->isChecked();
+    config["transcript_max_lines"] = historyLinesSpinBox->value();
     config["preferred_name"] = userComboBox->currentText();
     config["audio_device"] = deviceComboBox->currentText();
     
@@ -266,18 +430,33 @@ void SettingsFrame::saveSettings() {
     }
     
     // Save to file
+    if (writeConfigFile()) {
+        QMessageBox::information(this, "Settings", "Settings saved successfully!");
+    } else {
+        QMessageBox::warning(this, "Settings", "Failed to save settings!");
+    }
+}
+
+bool SettingsFrame::writeConfigFile() {
     QJsonObject jsonConfig;
     for (auto it = config.begin(); it != config.end(); ++it) {
         jsonConfig[it.key()] = QJsonValue::fromVariant(it.value());
     }
     
     QFile file("config.json");
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonDocument doc(jsonConfig);
-        file.write(doc.toJson(QJsonDocument::Indented));
-        QMessageBox::information(this, "Settings", "Settings saved successfully!");
-    } else {
-        QMessageBox::warning(this, "Settings", "Failed to save settings!");
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QJsonDocument doc(jsonConfig);
+    file.write(doc.toJson(QJsonDocument::Indented));
+    return true;
+}
+
+void SettingsFrame::setCalibratedThreads(int threads) {
+    // Persist right away so the benchmark does not rerun on the next start
+    config["calibrated_threads"] = threads;
+    if (!writeConfigFile()) {
+        qWarning() << "Failed to persist calibrated thread count";
     }
 }
 
@@ -295,8 +474,10 @@ void SettingsFrame::onSetHotkeyClicked() {
     }
 }
 
-void SettingsFrame::onRecordingModeChanged(bool toggleMode) {
-    config["recording_mode"] = toggleMode ? "toggle" : "push";
+void SettingsFrame::onRecordingModeChanged(int index) {
+    const QString mode = recordingModeComboBox->itemData(index).toString();
+    config["recording_mode"] = mode;
+    endpointTimeoutSpinBox->setEnabled(mode == "continuous");
 }
 
 void SettingsFrame::onSetActionHotkeyClicked(const QString& action) {
@@ -359,8 +540,68 @@ QString SettingsFrame::getPushToTalkKey() const {
     return hotkeyEdit->text();
 }
 
-bool SettingsFrame::isToggleModeEnabled() const {
-    return recordingModeSwitch->isChecked();
+QString SettingsFrame::getRecordingMode() const {
+    return recordingModeComboBox->currentData().toString();
+}
+
+int SettingsFrame::getEndpointTimeoutMs() const {
+    return endpointTimeoutSpinBox->value();
+}
+
+bool SettingsFrame::isWarmStreamEnabled() const {
+    return warmStreamCheckBox->isChecked();
+}
+
+int SettingsFrame::getPreRollMs() const {
+    return preRollSpinBox->value();
+}
+
+bool SettingsFrame::isCompactCaptureEnabled() const {
+    return compactCaptureCheckBox->isChecked();
+}
+
+QString SettingsFrame::getBusyPolicy() const {
+    return busyPolicyComboBox->currentData().toString();
+}
+
+int SettingsFrame::getWhisperThreads() const {
+    return threadsSpinBox->value();
+}
+
+int SettingsFrame::getCalibratedThreads() const {
+    return config.value("calibrated_threads", 0).toInt();
+}
+
+QString SettingsFrame::getInferenceAffinity() const {
+    return affinityEdit->text().trimmed();
+}
+
+bool SettingsFrame::isAdaptiveContextEnabled() const {
+    return adaptiveContextCheckBox->isChecked();
+}
+
+bool SettingsFrame::isVoiceActivityDetectionEnabled() const {
+    return vadCheckBox->isChecked();
+}
+
+bool SettingsFrame::isStreamingPartialsEnabled() const {
+    return streamingPartialsCheckBox->isChecked();
+}
+
+int SettingsFrame::getPartialIntervalMs() const {
+    return partialIntervalSpinBox->value();
+}
+
+int SettingsFrame::getResidentModels() const {
+    return residentModelsSpinBox->value();
+}
+
+bool SettingsFrame::isModelGovernorEnabled() const {
+    return modelGovernorCheckBox->isChecked();
+}
+
+int SettingsFrame::getTranscriptMaxLines() const {
+    return historyLinesSpinBox->value();
 }
 
 QString SettingsFrame::getActionHotkey(const QString& action) const {
@@ -9,6 +9,7 @@
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QGroupBox>
+#include <QtWidgets/QSpinBox>
 #include <memory>
 
 namespace whisper_client {
@@ -28,18 +29,38 @@ public:
     QString getWebSocketPort() const;
     bool isWebSocketEnabled() const;
     QString getPushToTalkKey() const;
-    bool isToggleModeEnabled() const;
+    QString getRecordingMode() const;   // "push", "toggle" or "continuous"
+    int getEndpointTimeoutMs() const;
+    bool isWarmStreamEnabled() const;
+    int getPreRollMs() const;
+    bool isCompactCaptureEnabled() const;
+    QString getBusyPolicy() const;
+    int getWhisperThreads() const;      // 0 means automatic
+    int getCalibratedThreads() const;   // 0 until calibrated
+    QString getInferenceAffinity() const;
+    bool isAdaptiveContextEnabled() const;
+    bool isVoiceActivityDetectionEnabled() const;
+    bool isStreamingPartialsEnabled() const;
+    int getPartialIntervalMs() const;
+    int getResidentModels() const;
+    bool isModelGovernorEnabled() const;
+    int getTranscriptMaxLines() const;
     QString getActionHotkey(const QString& action) const;
 
 public slots:
     void saveSettings();
     void loadSettings();
     void updateDeviceList();
+    void setCalibratedThreads(int threads);
+
+signals:
+    void calibrationRequested();
+    void modelVerifyRequested();
 
 private slots:
     void onWebSocketToggled(bool enabled);
     void onSetHotkeyClicked();
-    void onRecordingModeChanged(bool toggleMode);
+    void onRecordingModeChanged(int index);
     void onSetActionHotkeyClicked(const QString& action);
     void onDeviceSelectionChanged(int index);
     void onUserSelectionChanged(int index);
@@ -53,6 +74,8 @@ private:
     void createWebSocketSection();
     void createHotkeySection();
     void createActionHotkeysSection();
+    void createTranscriptionSection();
+    bool writeConfigFile();
     
     // UI Components
     QVBoxLayout *mainLayout;
@@ -76,7 +99,25 @@ private:
     // Push to talk settings
     QLineEdit *hotkeyEdit;
     QPushButton *hotkeyButton;
-    QCheckBox *recordingModeSwitch;
+    QComboBox *recordingModeComboBox;
+    QCheckBox *warmStreamCheckBox;
+    QSpinBox *preRollSpinBox;
+    QSpinBox *endpointTimeoutSpinBox;
+    QCheckBox *compactCaptureCheckBox;
+    
+    // Transcription settings
+    QComboBox *busyPolicyComboBox;
+    QSpinBox *threadsSpinBox;
+    QPushButton *calibrateButton;
+    QLineEdit *affinityEdit;
+    QCheckBox *adaptiveContextCheckBox;
+    QCheckBox *vadCheckBox;
+    QCheckBox *streamingPartialsCheckBox;
+    QSpinBox *partialIntervalSpinBox;
+    QSpinBox *residentModelsSpinBox;
+    QCheckBox *modelGovernorCheckBox;
+    QPushButton *verifyModelButton;
+    QSpinBox *historyLinesSpinBox;
     
     // Action hotkeys
     struct ActionHotkey {
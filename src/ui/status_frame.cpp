@@ -25,6 +25,12 @@ void StatusFrame::setupUi() {
     // Create sections
     createStatusIndicators();
     createMetricsDisplay();
+
+    // Model download progress, only shown while a download runs
+    downloadProgressBar = new QProgressBar(this);
+    downloadProgressBar->setFormat("Downloading model: %p%");
+    downloadProgressBar->hide();
+    mainLayout->addWidget(downloadProgressBar);
 }
 
 void StatusFrame::createStatusIndicators() {
@@ -49,11 +55,15 @@ void StatusFrame::createStatusIndicators() {
     botLayout->addWidget(botButton);
     botLayout->addStretch();
 
+    // Active model and its measured real-time factor
+    modelLabel = new QLabel("Model: -");
+
     // Add all indicators to status layout
     statusLayout->addWidget(wsStatusDot);
     statusLayout->addWidget(recordingStatusDot);
     statusLayout->addWidget(processingStatusDot);
     statusLayout->addWidget(botContainer);
+    statusLayout->addWidget(modelLabel);
     
     mainLayout->addWidget(statusGroup);
 
@@ -150,6 +160,29 @@ void StatusFrame::updateMetrics(int ttsQueue, int followers, int subscribers, in
     giftersLabel->setText(QString::number(gifters));
 }
 
+void StatusFrame::updateModelStatus(const QString& modelName, double realTimeFactor) {
+    if (realTimeFactor > 0.0) {
+        modelLabel->setText(QString("Model: %1 (RTF %2)").arg(modelName).arg(realTimeFactor, 0, 'f', 2));
+    } else {
+        modelLabel->setText(QString("Model: %1").arg(modelName));
+    }
+}
+
+void StatusFrame::updateDownloadProgress(qint64 bytesReceived, qint64 bytesTotal) {
+    if (bytesTotal > 0) {
+        // Per mille keeps the range inside int for multi-GB files
+        downloadProgressBar->setRange(0, 1000);
+        downloadProgressBar->setValue(static_cast<int>(bytesReceived * 1000 / bytesTotal));
+    } else {
+        downloadProgressBar->setRange(0, 0);  // Busy indicator, size unknown
+    }
+    downloadProgressBar->show();
+}
+
+void StatusFrame::hideDownloadProgress() {
+    downloadProgressBar->hide();
+}
+
 void StatusFrame::onBotToggle() {
     bool isConnected = botButton->text() == "Disconnect Bot";
     emit botToggleRequested(!isConnected);
@@ -4,6 +4,7 @@
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QProgressBar>
 #include <memory>
 
 namespace whisper_client {
@@ -22,6 +23,9 @@ public slots:
     void updateProcessingStatus(bool processing);
     void updateBotStatus(bool connected);
     void updateMetrics(int ttsQueue, int followers, int subscribers, int gifters);
+    void updateModelStatus(const QString& modelName, double realTimeFactor);
+    void updateDownloadProgress(qint64 bytesReceived, qint64 bytesTotal);
+    void hideDownloadProgress();
 
 private slots:
     void onBotToggle();
@@ -42,6 +46,8 @@ private:
     QLabel* processingStatusDot;
     QLabel* botStatusDot;
     QPushButton* botButton;
+    QLabel* modelLabel;
+    QProgressBar* downloadProgressBar;
 
     // Metrics labels
     QLabel* ttsQueueLabel;
@@ -9,6 +9,10 @@ TranscriptFrame::TranscriptFrame(QWidget *parent)
     : QFrame(parent)
 {
     setupUi();
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&flushTimer, &QTimer::timeout, this, &TranscriptFrame::flushPendingMessages);
 }
 
 TranscriptFrame::~TranscriptFrame() = default;
@@ -23,25 +27,54 @@ void TranscriptFrame::setupUi() {
     auto* groupBox = new QGroupBox("Transcription Results:", this);
     auto* groupLayout = new QVBoxLayout(groupBox);
 
-    // Create transcript text area
-    transcriptText = new QTextEdit(this);
-    transcriptText->setReadOnly(true);
-    transcriptText->setLineWrapMode(QTextEdit::WidgetWidth);
-    transcriptText->setMinimumHeight(200);  // Ensure reasonable default height
+    // Create transcript view; rows are painted only when visible, and their
+    // heights come from the model's cache after the first measurement
+    transcriptModel = new TranscriptModel(DEFAULT_MAX_MESSAGES, this);
+    transcriptView = new QListView(this);
+    transcriptView->setModel(transcriptModel);
+    transcriptView->setItemDelegate(new TranscriptDelegate(transcriptView));
+    transcriptView->setSelectionMode(QAbstractItemView::NoSelection);
+    transcriptView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    transcriptView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    transcriptView->setResizeMode(QListView::Adjust);
+    transcriptView->setLayoutMode(QListView::Batched);
+    transcriptView->setBatchSize(200);
+    transcriptView->setWordWrap(true);
+    transcriptView->setMinimumHeight(200);  // Ensure reasonable default height
     
     // Set dark theme specific styling
-    transcriptText->setStyleSheet(
-        "QTextEdit {"
+    transcriptView->setStyleSheet(
+        "QListView {"
         "   background-color: #2d2d2d;"
         "   color: white;"
         "   border: 1px solid #555;"
         "}"
-        "QTextEdit:focus {"
+        "QListView:focus {"
         "   border: 1px solid #666;"
         "}"
     );
 
-    groupLayout->addWidget(transcriptText);
+    // Provisional text from streaming partials
+    provisionalLabel = new QLabel(this);
+    provisionalLabel->setWordWrap(true);
+    provisionalLabel->setTextFormat(Qt::PlainText);
+    provisionalLabel->setStyleSheet("QLabel { color: gray; font-style: italic; }");
+    provisionalLabel->hide();
+
+    // Searches the persisted transcript history
+    searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText("Search history (words, @user)");
+    searchEdit->setClearButtonEnabled(true);
+    connect(searchEdit, &QLineEdit::returnPressed, this, [this]() {
+        const QString query = searchEdit->text().trimmed();
+        if (!query.isEmpty()) {
+            emit historySearchRequested(query);
+        }
+    });
+
+    groupLayout->addWidget(searchEdit);
+    groupLayout->addWidget(transcriptView);
+    groupLayout->addWidget(provisionalLabel);
     mainLayout->addWidget(groupBox);
 }
 
@@ -67,28 +100,60 @@ void TranscriptFrame::appendSystemMessage(const QString& message) {
 }
 
 void TranscriptFrame::appendMessage(const QString& prefix, const QString& message, const QString& color) {
-    // Create timestamp
-    QDateTime now = QDateTime::currentDateTime();
-    QString timestamp = now.toString("hh:mm:ss");
-
-    // Format message with HTML
-    QString formattedMessage = QString("<span style='color: gray;'>[%1]</span> "
-                                     "<span style='color: %2;'>[%3]:</span> %4")
-                                     .arg(timestamp)
-                                     .arg(color)
-                                     .arg(prefix)
-                                     .arg(message);
-
-    // Append message
-    transcriptText->append(formattedMessage);
-
-    // Auto-scroll to bottom
-    QScrollBar* scrollBar = transcriptText->verticalScrollBar();
-    scrollBar->setValue(scrollBar->maximum());
+    // Queue message with its timestamp; handed to the model on the next flush
+    TranscriptMessage record;
+    record.time = QDateTime::currentDateTime().toString("hh:mm:ss");
+    record.prefix = prefix;
+    record.text = message;
+    record.color = QColor(color).rgb();
+    pendingMessages.push_back(std::move(record));
+
+    if (!flushTimer.isActive()) {
+        flushTimer.start();
+    }
+}
+
+void TranscriptFrame::flushPendingMessages() {
+    if (pendingMessages.empty()) {
+        return;
+    }
+
+    // Follow new lines only if the user has not scrolled up
+    QScrollBar* scrollBar = transcriptView->verticalScrollBar();
+    const bool atBottom = scrollBar->value() >= scrollBar->maximum();
+
+    transcriptModel->append(std::move(pendingMessages));
+    pendingMessages.clear();
+
+    if (atBottom) {
+        transcriptView->scrollToBottom();
+    }
+}
+
+void TranscriptFrame::setMaxMessages(int maxMessages) {
+    transcriptModel->setMaxMessages(maxMessages);
+}
+
+void TranscriptFrame::setProvisionalText(const QString& username, const QString& text) {
+    QString message = text.trimmed();
+    if (message.isEmpty()) {
+        clearProvisionalText();
+        return;
+    }
+    provisionalLabel->setText(QString("[%1]: %2").arg(username, message));
+    provisionalLabel->show();
+}
+
+void TranscriptFrame::clearProvisionalText() {
+    provisionalLabel->clear();
+    provisionalLabel->hide();
 }
 
 void TranscriptFrame::clear() {
-    transcriptText->clear();
+    flushTimer.stop();
+    pendingMessages.clear();
+    transcriptModel->clear();
+    clearProvisionalText();
 }
 
 } // namespace ui
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <QtWidgets/QFrame>
-#include <QtWidgets/QTextEdit>
+#include <QtWidgets/QListView>
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QLineEdit>
 #include <QtCore/QString>
 #include <QtCore/QDateTime>
+#include <QtCore/QTimer>
 #include <memory>
+#include <vector>
+#include "ui/transcript_model.hpp"
 
 namespace whisper_client {
 namespace ui {
@@ -24,12 +28,35 @@ public slots:
     void appendSystemMessage(const QString& message);
     void clear();
 
+    // Oldest lines are dropped beyond this many
+    void setMaxMessages(int maxMessages);
+
+    // Text that may still change while the user is speaking; shown below the
+    // transcript until the final result replaces it
+    void setProvisionalText(const QString& username, const QString& text);
+    void clearProvisionalText();
+
+signals:
+    // Query typed into the history search box
+    void historySearchRequested(const QString& query);
+
 private:
     void setupUi();
     void appendMessage(const QString& prefix, const QString& message, const QString& color = "white");
+    void flushPendingMessages();
 
     QVBoxLayout* mainLayout;
-    QTextEdit* transcriptText;
+    QLineEdit* searchEdit;
+    QListView* transcriptView;
+    TranscriptModel* transcriptModel;
+    QLabel* provisionalLabel;
+
+    // Messages are queued and handed to the model once per frame, so a burst
+    // costs a single relayout and scroll
+    std::vector<TranscriptMessage> pendingMessages;
+    QTimer flushTimer;
+    static constexpr int FLUSH_INTERVAL_MS = 16;
+    static constexpr int DEFAULT_MAX_MESSAGES = 5000;
 
     // Color scheme for different message types
     const QString userColor = "#2ecc71";      // Green for user messages
@@ -0,0 +1,198 @@
+#include "ui/transcript_model.hpp"
+#include <QtGui/QPainter>
+#include <QtGui/QFontMetrics>
+#include <algorithm>
+#include <climits>
+
+namespace whisper_client {
+namespace ui {
+
+TranscriptModel::TranscriptModel(int maxMessages, QObject* parent)
+    : QAbstractListModel(parent)
+    , ring(static_cast<size_t>(std::max(1, maxMessages)))
+    , head(0)
+    , count(0)
+    , heights(ring.size(), -1)
+    , heightWidth(0)
+{
+}
+
+void TranscriptModel::setMaxMessages(int maxMessages) {
+    const size_t capacity = static_cast<size_t>(std::max(1, maxMessages));
+    if (capacity == ring.size()) {
+        return;
+    }
+
+    // Keep the newest lines that fit
+    beginResetModel();
+    const size_t kept = std::min(count, capacity);
+    std::vector<TranscriptMessage> resized(capacity);
+    std::vector<int> resizedHeights(capacity, -1);
+    for (size_t i = 0; i < kept; ++i) {
+        const size_t from = (head + count - kept + i) % ring.size();
+        resized[i] = std::move(ring[from]);
+        resizedHeights[i] = heights[from];
+    }
+    ring = std::move(resized);
+    heights = std::move(resizedHeights);
+    head = 0;
+    count = kept;
+    endResetModel();
+}
+
+void TranscriptModel::append(std::vector<TranscriptMessage>&& batch) {
+    if (batch.empty()) {
+        return;
+    }
+
+    const size_t capacity = ring.size();
+    size_t first = 0;
+    if (batch.size() > capacity) {
+        first = batch.size() - capacity;  // Older than anything we could keep
+    }
+    const size_t incoming = batch.size() - first;
+
+    // Make room by dropping the oldest rows
+    if (count + incoming > capacity) {
+        const size_t overflow = count + incoming - capacity;
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(overflow) - 1);
+        head = (head + overflow) % capacity;
+        count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), static_cast<int>(count), static_cast<int>(count + incoming) - 1);
+    for (size_t i = first; i < batch.size(); ++i) {
+        const size_t index = (head + count) % capacity;
+        ring[index] = std::move(batch[i]);
+        heights[index] = -1;
+        ++count;
+    }
+    endInsertRows();
+}
+
+void TranscriptModel::clear() {
+    beginResetModel();
+    for (auto& message : ring) {
+        message = TranscriptMessage();
+    }
+    std::fill(heights.begin(), heights.end(), -1);
+    head = 0;
+    count = 0;
+    endResetModel();
+}
+
+int TranscriptModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(count);
+}
+
+QVariant TranscriptModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || static_cast<size_t>(index.row()) >= count) {
+        return QVariant();
+    }
+
+    const TranscriptMessage& message = at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return message.text;
+    case TimeRole:
+        return message.time;
+    case PrefixRole:
+        return message.prefix;
+    case ColorRole:
+        return QColor(message.color);
+    default:
+        return QVariant();
+    }
+}
+
+int TranscriptModel::cachedHeight(int row, int width) const {
+    if (width != heightWidth || row < 0 || static_cast<size_t>(row) >= count) {
+        return -1;
+    }
+    return heights[slot(row)];
+}
+
+void TranscriptModel::cacheHeight(int row, int width, int height) const {
+    if (row < 0 || static_cast<size_t>(row) >= count) {
+        return;
+    }
+    if (width != heightWidth) {
+        // Wrapping changes with the width, so every row needs measuring again
+        std::fill(heights.begin(), heights.end(), -1);
+        heightWidth = width;
+    }
+    heights[slot(row)] = height;
+}
+
+TranscriptDelegate::TranscriptDelegate(QListView* view)
+    : QStyledItemDelegate(view)
+    , view(view)
+{
+}
+
+namespace {
+
+QString headerText(const QModelIndex& index, QString* time, QString* prefix) {
+    *time = QString("[%1] ").arg(index.data(TranscriptModel::TimeRole).toString());
+    *prefix = QString("[%1]: ").arg(index.data(TranscriptModel::PrefixRole).toString());
+    return *time + *prefix;
+}
+
+} // namespace
+
+void TranscriptDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QString time;
+    QString prefix;
+    headerText(index, &time, &prefix);
+    const QFontMetrics metrics(option.font);
+    const QRect rect = option.rect.adjusted(PADDING, PADDING, -PADDING, -PADDING);
+
+    painter->save();
+    painter->setFont(option.font);
+
+    int x = rect.left();
+    painter->setPen(QColor("gray"));
+    painter->drawText(QRect(x, rect.top(), rect.width(), metrics.height()), Qt::AlignLeft, time);
+    x += metrics.horizontalAdvance(time);
+
+    painter->setPen(index.data(TranscriptModel::ColorRole).value<QColor>());
+    painter->drawText(QRect(x, rect.top(), rect.right() - x, metrics.height()), Qt::AlignLeft, prefix);
+    x += metrics.horizontalAdvance(prefix);
+
+    // Message wraps under itself, leaving the header as a hanging indent
+    painter->setPen(option.palette.color(QPalette::Text));
+    painter->drawText(QRect(x, rect.top(), std::max(1, rect.right() - x), rect.height()),
+                      Qt::AlignLeft | Qt::TextWordWrap, index.data(Qt::DisplayRole).toString());
+
+    painter->restore();
+}
+
+QSize TranscriptDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    const int width = view->viewport()->width() - 2 * PADDING;
+    const auto* model = qobject_cast<const TranscriptModel*>(index.model());
+    if (model) {
+        const int cached = model->cachedHeight(index.row(), width);
+        if (cached >= 0) {
+            return QSize(width, cached);
+        }
+    }
+
+    QString time;
+    QString prefix;
+    const QString header = headerText(index, &time, &prefix);
+    const QFontMetrics metrics(option.font);
+
+    const int textWidth = std::max(1, width - metrics.horizontalAdvance(header));
+    const QRect bounds = metrics.boundingRect(QRect(0, 0, textWidth, INT_MAX),
+                                              Qt::AlignLeft | Qt::TextWordWrap,
+                                              index.data(Qt::DisplayRole).toString());
+    const int height = std::max(bounds.height(), metrics.height()) + 2 * PADDING;
+    if (model) {
+        model->cacheHeight(index.row(), width, height);
+    }
+    return QSize(width, height);
+}
+
+} // namespace ui
+} // namespace whisper_client
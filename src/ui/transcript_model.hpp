@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QString>
+#include <QtGui/QColor>
+#include <QtWidgets/QStyledItemDelegate>
+#include <QtWidgets/QListView>
+#include <vector>
+
+namespace whisper_client {
+namespace ui {
+
+// One transcript line, kept as plain fields and painted only when visible
+struct TranscriptMessage {
+    QString time;
+    QString prefix;
+    QString text;
+    QRgb color = 0;
+};
+
+// Transcript log as a fixed-capacity ring. Once full, each append drops the
+// oldest lines, so memory and per-append cost stay bounded however long the
+// session runs.
+class TranscriptModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        TimeRole = Qt::UserRole + 1,
+        PrefixRole,
+        ColorRole
+    };
+
+    explicit TranscriptModel(int maxMessages, QObject* parent = nullptr);
+
+    void setMaxMessages(int maxMessages);
+    int maxMessages() const { return static_cast<int>(ring.size()); }
+
+    void append(std::vector<TranscriptMessage>&& batch);
+    void clear();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // Row heights measured by the delegate. QListView asks for the size of
+    // every row whenever rows are inserted or removed, so each row is
+    // measured once per view width and looked up after that. -1 if the row
+    // has not been measured at this width.
+    int cachedHeight(int row, int width) const;
+    void cacheHeight(int row, int width, int height) const;
+
+private:
+    size_t slot(int row) const {
+        return (head + static_cast<size_t>(row)) % ring.size();
+    }
+    const TranscriptMessage& at(int row) const {
+        return ring[slot(row)];
+    }
+
+    std::vector<TranscriptMessage> ring;
+    size_t head;    // Index of row 0
+    size_t count;
+
+    mutable std::vector<int> heights;  // Parallel to ring
+    mutable int heightWidth;           // Width the cached heights were measured at
+};
+
+// Paints "[time] [prefix]: text" with the text wrapped under itself
+class TranscriptDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit TranscriptDelegate(QListView* view);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QListView* view;
+    static constexpr int PADDING = 2;
+};
+
+} // namespace ui
+} // namespace whisper_client
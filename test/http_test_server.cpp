@@ -0,0 +1,159 @@
+#include "http_test_server.hpp"
+#include <QtNetwork/QHostAddress>
+#include <algorithm>
+
+namespace whisper_client {
+namespace test {
+
+namespace {
+
+QByteArray reasonPhrase(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 404: return "Not Found";
+    case 416: return "Range Not Satisfiable";
+    case 503: return "Service Unavailable";
+    default: return "Error";
+    }
+}
+
+// "bytes=<first>-" or "bytes=<first>-<last>"; last is clamped to the body
+bool parseRange(const QByteArray& range, qint64 total, qint64* first, qint64* last) {
+    if (!range.startsWith("bytes=")) {
+        return false;
+    }
+    const QList<QByteArray> bounds = range.mid(6).split('-');
+    if (bounds.size() != 2) {
+        return false;
+    }
+    bool ok = false;
+    *first = bounds[0].toLongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    *last = bounds[1].isEmpty() ? total - 1 : std::min(total - 1, bounds[1].toLongLong(&ok));
+    return ok;
+}
+
+} // namespace
+
+HttpTestServer::HttpTestServer(QObject* parent)
+    : QTcpServer(parent)
+    , honourRanges(true)
+    , errorStatus(0)
+    , linkedSize(0)
+    , dropCount(0)
+    , dropAfter(0)
+{
+    connect(this, &QTcpServer::newConnection, this, &HttpTestServer::onNewConnection);
+}
+
+bool HttpTestServer::start() {
+    return listen(QHostAddress::LocalHost, 0);
+}
+
+QString HttpTestServer::baseUrl() const {
+    return QString("http://127.0.0.1:%1/models").arg(serverPort());
+}
+
+void HttpTestServer::setLinkedDigest(const QByteArray& sha256, qint64 size) {
+    linkedSha256 = sha256;
+    linkedSize = size;
+}
+
+void HttpTestServer::dropConnections(int count, qint64 afterBytes) {
+    dropCount = count;
+    dropAfter = afterBytes;
+}
+
+int HttpTestServer::requestCount(const QByteArray& method) const {
+    return static_cast<int>(std::count_if(received.begin(), received.end(),
+                                          [&method](const Request& request) { return request.method == method; }));
+}
+
+void HttpTestServer::onNewConnection() {
+    while (QTcpSocket* socket = nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            onReadyRead(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            pendingHeaders.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void HttpTestServer::onReadyRead(QTcpSocket* socket) {
+    QByteArray& pending = pendingHeaders[socket];
+    pending += socket->readAll();
+    const int headerEnd = pending.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return;
+    }
+
+    const QList<QByteArray> lines = pending.left(headerEnd).split('\n');
+    pendingHeaders.remove(socket);
+
+    Request request;
+    request.method = lines.value(0).split(' ').value(0);
+    for (int i = 1; i < lines.size(); ++i) {
+        const int colon = lines[i].indexOf(':');
+        if (colon > 0 && lines[i].left(colon).trimmed().toLower() == "range") {
+            request.range = lines[i].mid(colon + 1).trimmed();
+        }
+    }
+    received.append(request);
+    respond(socket, request);
+}
+
+void HttpTestServer::respond(QTcpSocket* socket, const Request& request) {
+    const qint64 total = body.size();
+    const bool get = request.method == "GET";
+    int status = 200;
+    QByteArray payload = body;
+    QList<QByteArray> headers;
+
+    qint64 first = 0;
+    qint64 last = 0;
+    if (get && errorStatus != 0) {
+        status = errorStatus;
+        payload = "<html><body><h1>" + reasonPhrase(status) + "</h1></body></html>";
+    } else if (get && honourRanges && !request.range.isEmpty()) {
+        if (!parseRange(request.range, total, &first, &last) || first >= total || last < first) {
+            status = 416;
+            payload.clear();
+            headers << "Content-Range: bytes */" + QByteArray::number(total);
+        } else {
+            status = 206;
+            payload = body.mid(first, last - first + 1);
+            headers << "Content-Range: bytes " + QByteArray::number(first) + "-" +
+                           QByteArray::number(last) + "/" + QByteArray::number(total);
+        }
+    }
+
+    if (!linkedSha256.isEmpty()) {
+        headers << "X-Linked-ETag: \"" + linkedSha256 + "\"";
+        headers << "X-Linked-Size: " + QByteArray::number(linkedSize);
+    }
+    headers << "Content-Length: " + QByteArray::number(payload.size());
+    headers << "Accept-Ranges: bytes";
+    headers << "Connection: close";
+
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " + reasonPhrase(status) + "\r\n" +
+                          headers.join("\r\n") + "\r\n\r\n";
+    if (get && dropCount > 0) {
+        // Announce the full length, then hang up part way through
+        --dropCount;
+        payload = payload.left(dropAfter);
+    }
+    if (get) {
+        response += payload;
+    }
+
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+} // namespace test
+} // namespace whisper_client
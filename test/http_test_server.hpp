@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+namespace whisper_client {
+namespace test {
+
+// Local stand-in for the model host. Serves one body for any path, over
+// HTTP/1.1 with one request per connection, and can be told to misbehave.
+class HttpTestServer : public QTcpServer {
+    Q_OBJECT
+
+public:
+    struct Request {
+        QByteArray method;
+        QByteArray range;   // Value of the Range header, empty if none
+    };
+
+    explicit HttpTestServer(QObject* parent = nullptr);
+
+    bool start();               // Listens on 127.0.0.1 on a free port
+    QString baseUrl() const;
+
+    void setBody(const QByteArray& content) { body = content; }
+
+    // false: answer GETs with 200 and the whole body even when a Range is
+    // requested. HEAD still advertises byte ranges.
+    void setHonourRanges(bool honour) { honourRanges = honour; }
+
+    // Non-zero: answer every GET with this status and an HTML error page
+    void setErrorStatus(int status) { errorStatus = status; }
+
+    // Send the digest Hugging Face publishes for LFS files, as X-Linked-ETag
+    // and X-Linked-Size; an empty sha256 sends nothing
+    void setLinkedDigest(const QByteArray& sha256, qint64 size);
+
+    // The next count GETs close the connection after afterBytes of body
+    void dropConnections(int count, qint64 afterBytes);
+
+    const QList<Request>& requests() const { return received; }
+    int requestCount(const QByteArray& method) const;
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    void respond(QTcpSocket* socket, const Request& request);
+
+    QByteArray body;
+    bool honourRanges;
+    int errorStatus;
+    QByteArray linkedSha256;
+    qint64 linkedSize;
+    int dropCount;
+    qint64 dropAfter;
+    QHash<QTcpSocket*, QByteArray> pendingHeaders;
+    QList<Request> received;
+};
+
+} // namespace test
+} // namespace whisper_client
@@ -1,4 +1,65 @@
-int main() {
-    // Test runner will go here
-    return 0;
-}
\ No newline at end of file
+#include "test_support.hpp"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <cstdio>
+#include <cstring>
+
+namespace whisper_client {
+namespace test {
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+bool waitUntil(const std::function<bool()>& condition, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        QThread::msleep(1);
+    }
+    return true;
+}
+
+} // namespace test
+} // namespace whisper_client
+
+// Runs the named test case, or every case when no name is given
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    const char* only = argc > 1 ? argv[1] : nullptr;
+
+    int ran = 0;
+    int failed = 0;
+    int skipped = 0;
+    for (const auto& testCase : whisper_client::test::registry()) {
+        if (only && std::strcmp(only, testCase.name) != 0) {
+            continue;
+        }
+        ++ran;
+        try {
+            testCase.function();
+            std::printf("PASS %s\n", testCase.name);
+        } catch (const whisper_client::test::Skipped& e) {
+            ++skipped;
+            std::printf("SKIP %s: %s\n", testCase.name, e.what());
+        } catch (const std::exception& e) {
+            ++failed;
+            std::printf("FAIL %s: %s\n", testCase.name, e.what());
+        }
+    }
+
+    if (ran == 0) {
+        std::printf("No test named %s\n", only ? only : "");
+        return 1;
+    }
+    if (failed > 0) {
+        return 1;
+    }
+    return skipped == ran ? whisper_client::test::SKIP_RETURN_CODE : 0;
+}
@@ -0,0 +1,128 @@
+#include "test_support.hpp"
+#include "audio/mel_frontend.hpp"
+#include "whisper.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using whisper_client::audio::MelFrontend;
+using whisper_client::audio::MelSpectrogram;
+
+namespace {
+
+constexpr int SAMPLE_RATE = 16000;
+constexpr double PI = 3.14159265358979323846;
+
+// A few seconds with tones, a sweep, gaps and broadband noise, so every
+// mel band and the clamp to 80 dB below the peak are exercised
+std::vector<float> makeClip(double seconds) {
+    const size_t count = static_cast<size_t>(seconds * SAMPLE_RATE);
+    std::vector<float> samples(count);
+    unsigned int noise = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        const double t = double(i) / SAMPLE_RATE;
+        noise = noise * 1664525u + 1013904223u;
+        double value = 0.02 * (double(noise >> 8) / double(1 << 24) - 0.5);
+        if (std::fmod(t, 1.0) < 0.6) {
+            value += 0.3 * std::sin(2.0 * PI * 440.0 * t) + 0.1 * std::sin(2.0 * PI * 3100.0 * t);
+        }
+        value += 0.2 * std::sin(2.0 * PI * (100.0 + 900.0 * t) * t);
+        samples[i] = static_cast<float>(value);
+    }
+    return samples;
+}
+
+MelSpectrogram computeMel(const std::vector<float>& samples, int nMel, size_t blockSize) {
+    MelFrontend frontend(nMel);
+    for (size_t pos = 0; pos < samples.size(); pos += blockSize) {
+        frontend.addSamples(samples.data() + pos, std::min(blockSize, samples.size() - pos));
+    }
+    return frontend.finish();
+}
+
+struct ContextDeleter {
+    void operator()(whisper_context* ctx) const { whisper_free(ctx); }
+};
+
+struct StateDeleter {
+    void operator()(whisper_state* state) const { whisper_free_state(state); }
+};
+
+// Encodes the mel already in state and returns the logits that follow the
+// start-of-transcript token
+std::vector<float> firstTokenLogits(whisper_context* ctx, whisper_state* state) {
+    CHECK(whisper_encode_with_state(ctx, state, 0, 4) == 0);
+    const whisper_token sot = whisper_token_sot(ctx);
+    CHECK(whisper_decode_with_state(ctx, state, &sot, 1, 0, 4) == 0);
+    const float* logits = whisper_get_logits_from_state(state);
+    return std::vector<float>(logits, logits + whisper_n_vocab(ctx));
+}
+
+} // namespace
+
+TEST_CASE(mel_frontend_block_size_invariance) {
+    // Capture delivers audio in whatever blocks the device uses; the
+    // spectrogram must not depend on them
+    const std::vector<float> clip = makeClip(3.3);
+    for (int nMel : {80, 128}) {
+        const MelSpectrogram whole = computeMel(clip, nMel, clip.size());
+        CHECK(whole.nMel == nMel);
+        CHECK(whole.nLen == static_cast<int>((clip.size() + 30 * SAMPLE_RATE) / 160));
+        CHECK(whole.data.size() == static_cast<size_t>(nMel) * whole.nLen);
+
+        for (size_t blockSize : {1, 159, 160, 161, 400, 1024}) {
+            const MelSpectrogram blocked = computeMel(clip, nMel, blockSize);
+            CHECK(blocked.nLen == whole.nLen);
+            CHECK(blocked.nLenOrg == whole.nLenOrg);
+            CHECK(blocked.data == whole.data);
+        }
+    }
+}
+
+TEST_CASE(mel_frontend_matches_whisper) {
+    // Needs a real model for its mel filters and encoder, e.g. ggml-tiny.bin
+    const QByteArray modelPath = qgetenv("WHISPER_CLIENT_TEST_MODEL");
+    if (modelPath.isEmpty()) {
+        SKIP("set WHISPER_CLIENT_TEST_MODEL to a ggml model file");
+    }
+
+    std::unique_ptr<whisper_context, ContextDeleter> ctx(
+        whisper_init_from_file_with_params(modelPath.constData(), whisper_context_default_params()));
+    CHECK(ctx);
+    std::unique_ptr<whisper_state, StateDeleter> reference(whisper_init_state(ctx.get()));
+    std::unique_ptr<whisper_state, StateDeleter> precomputed(whisper_init_state(ctx.get()));
+    CHECK(reference && precomputed);
+
+    const std::vector<float> clip = makeClip(5.0);
+    const int nMel = whisper_model_n_mels(ctx.get());
+    const MelSpectrogram mel = computeMel(clip, nMel, 480);
+
+    CHECK(whisper_pcm_to_mel_with_state(ctx.get(), reference.get(), clip.data(),
+                                        static_cast<int>(clip.size()), 4) == 0);
+    CHECK(whisper_set_mel_with_state(ctx.get(), precomputed.get(), mel.data.data(), mel.nLen, mel.nMel) == 0);
+    CHECK(whisper_n_len_from_state(reference.get()) == whisper_n_len_from_state(precomputed.get()));
+
+    // whisper.h does not hand out the mel it computed, so the two are
+    // compared through what the model makes of them
+    const std::vector<float> expected = firstTokenLogits(ctx.get(), reference.get());
+    const std::vector<float> actual = firstTokenLogits(ctx.get(), precomputed.get());
+    CHECK(expected.size() == actual.size());
+
+    double maxDiff = 0.0;
+    double maxLogit = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        maxDiff = std::max(maxDiff, double(std::abs(expected[i] - actual[i])));
+        maxLogit = std::max(maxLogit, double(std::abs(expected[i])));
+    }
+    std::printf("  %d mel bins: max logit difference %.5f (largest logit %.2f)\n", nMel, maxDiff, maxLogit);
+    CHECK(maxDiff < 1e-2 * std::max(1.0, maxLogit));
+
+    const auto best = [](const std::vector<float>& logits) {
+        return std::max_element(logits.begin(), logits.end()) - logits.begin();
+    };
+    CHECK(best(expected) == best(actual));
+}
@@ -0,0 +1,251 @@
+#include "test_support.hpp"
+#include "http_test_server.hpp"
+#include "audio/model_manager.hpp"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+
+using whisper_client::audio::ModelManager;
+using whisper_client::test::HttpTestServer;
+using whisper_client::test::waitUntil;
+
+namespace {
+
+// A catalogue entry of the tests' own, pinned to the test body or left
+// unpinned so the download is held to what the test server announces
+const QString MODEL = "test-model";
+constexpr qint64 RESUME_BYTES = 700000;
+
+// Large enough for three segments of the 8 MB minimum
+constexpr qint64 SEGMENTED_BYTES = 3 * 8 * 1024 * 1024 + 12345;
+constexpr int SEGMENTS = 3;
+
+QByteArray makeBody(qint64 size) {
+    QByteArray body(size, Qt::Uninitialized);
+    for (qint64 i = 0; i < size; ++i) {
+        body[i] = static_cast<char>((i * 131 + i / 4099) & 0xff);
+    }
+    return body;
+}
+
+QByteArray sha256(const QByteArray& data) {
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+}
+
+QByteArray readFile(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void writeFile(const QString& path, const QByteArray& data) {
+    QFile file(path);
+    CHECK(file.open(QIODevice::WriteOnly));
+    CHECK(file.write(data) == data.size());
+}
+
+// A ModelManager pointed at the test server and a scratch model directory
+struct DownloadFixture {
+    QTemporaryDir directory;
+    HttpTestServer server;
+    ModelManager manager;
+    bool done = false;
+    bool success = false;
+    QString message;
+
+    DownloadFixture(const QByteArray& body, int segments, bool pinned = false) {
+        CHECK(directory.isValid());
+        CHECK(server.start());
+        server.setBody(body);
+        qputenv("WHISPER_CLIENT_MODEL_BASE_URL", server.baseUrl().toUtf8());
+        manager.setModelDirectory(directory.path());
+        manager.addModel(MODEL, server.baseUrl() + "/ggml-" + MODEL + ".bin",
+                         pinned ? body.size() : 0, pinned ? QString::fromLatin1(sha256(body)) : QString());
+        manager.setDownloadSegments(segments);
+        QObject::connect(&manager, &ModelManager::downloadComplete, &manager,
+                         [this](bool ok, const QString& text) {
+                             done = true;
+                             success = ok;
+                             message = text;
+                         });
+    }
+
+    QString modelPath() const { return manager.getModelPath(MODEL); }
+    QString partPath() const { return modelPath() + ".part"; }
+
+    // Manifest entry written when the download completed
+    QJsonObject manifestEntry() const {
+        const QJsonObject manifest = QJsonDocument::fromJson(readFile(directory.filePath("manifest.json"))).object();
+        return manifest.value(QFileInfo(modelPath()).absoluteFilePath()).toObject();
+    }
+    QString recordedHash() const { return manifestEntry().value("sha256").toString(); }
+
+    void download() {
+        manager.downloadModel(MODEL);
+        CHECK(waitUntil([this]() { return done; }));
+    }
+};
+
+} // namespace
+
+TEST_CASE(streaming_fresh_download) {
+    const QByteArray body = makeBody(3 * 1024 * 1024 + 17);
+    DownloadFixture fixture(body, 1);
+
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(readFile(fixture.modelPath()) == body);
+    CHECK(!QFile::exists(fixture.partPath()));
+    CHECK(fixture.server.requestCount("GET") == 1);
+    CHECK(fixture.server.requests().last().range.isEmpty());
+}
+
+TEST_CASE(streaming_resume_partial_content) {
+    const QByteArray body = makeBody(2 * 1024 * 1024 + 5);
+    DownloadFixture fixture(body, 1);
+    writeFile(fixture.partPath(), body.left(RESUME_BYTES));
+
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(fixture.server.requests().last().range == "bytes=" + QByteArray::number(RESUME_BYTES) + "-");
+    CHECK(readFile(fixture.modelPath()) == body);
+    CHECK(!QFile::exists(fixture.partPath()));
+}
+
+TEST_CASE(streaming_resume_server_ignores_range) {
+    const QByteArray body = makeBody(2 * 1024 * 1024 + 5);
+    DownloadFixture fixture(body, 1);
+    fixture.server.setHonourRanges(false);
+    // Whatever is on disk must be replaced by the full body, not kept in front of it
+    writeFile(fixture.partPath(), QByteArray(RESUME_BYTES, 'x'));
+
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(!fixture.server.requests().last().range.isEmpty());
+    CHECK(readFile(fixture.modelPath()) == body);
+}
+
+TEST_CASE(streaming_resume_error_status) {
+    const QByteArray body = makeBody(2 * 1024 * 1024 + 5);
+    DownloadFixture fixture(body, 1);
+    fixture.server.setErrorStatus(503);
+    writeFile(fixture.partPath(), body.left(RESUME_BYTES));
+
+    // The error page must neither be appended nor replace what was resumable
+    fixture.download();
+    CHECK(!fixture.success);
+    CHECK(readFile(fixture.partPath()) == body.left(RESUME_BYTES));
+    CHECK(!QFile::exists(fixture.modelPath()));
+
+    // A later attempt resumes from the same point
+    fixture.done = false;
+    fixture.server.setErrorStatus(0);
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(readFile(fixture.modelPath()) == body);
+}
+
+TEST_CASE(segmented_download) {
+    const QByteArray body = makeBody(SEGMENTED_BYTES);
+    DownloadFixture fixture(body, SEGMENTS, true);
+
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(readFile(fixture.modelPath()) == body);
+    CHECK(fixture.recordedHash() == sha256(body));
+    CHECK(fixture.server.requestCount("HEAD") == 1);
+    CHECK(fixture.server.requestCount("GET") == SEGMENTS);
+
+    QList<QByteArray> ranges;
+    for (const auto& request : fixture.server.requests()) {
+        if (request.method == "GET") {
+            CHECK(!request.range.isEmpty());
+            CHECK(!ranges.contains(request.range));
+            ranges.append(request.range);
+        }
+    }
+}
+
+TEST_CASE(segmented_retry_after_dropped_connection) {
+    const QByteArray body = makeBody(SEGMENTED_BYTES);
+    DownloadFixture fixture(body, SEGMENTS, true);
+    constexpr qint64 dropAfter = 1024 * 1024;
+    fixture.server.dropConnections(1, dropAfter);
+
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(readFile(fixture.modelPath()) == body);
+    CHECK(fixture.recordedHash() == sha256(body));
+    CHECK(fixture.server.requestCount("GET") == SEGMENTS + 1);
+
+    // The retry picks up where the dropped segment stopped
+    const qint64 segmentBytes = (SEGMENTED_BYTES + SEGMENTS - 1) / SEGMENTS;
+    const QByteArray retryRange = fixture.server.requests().last().range;
+    bool resumedMidSegment = false;
+    for (int i = 0; i < SEGMENTS; ++i) {
+        resumedMidSegment |= retryRange.startsWith("bytes=" + QByteArray::number(i * segmentBytes + dropAfter) + "-");
+    }
+    CHECK(resumedMidSegment);
+}
+
+TEST_CASE(segmented_range_answered_with_full_body) {
+    const QByteArray body = makeBody(SEGMENTED_BYTES);
+    DownloadFixture fixture(body, SEGMENTS);
+    fixture.server.setHonourRanges(false);
+
+    // Falls back to a single stream rather than splicing whole bodies together
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(readFile(fixture.modelPath()) == body);
+    CHECK(fixture.server.requests().last().range.isEmpty());
+}
+
+TEST_CASE(streaming_published_digest) {
+    const QByteArray body = makeBody(2 * 1024 * 1024 + 5);
+    DownloadFixture fixture(body, 1);
+    fixture.server.setLinkedDigest(sha256(body), body.size());
+
+    fixture.download();
+    CHECK(fixture.success);
+    CHECK(fixture.server.requestCount("HEAD") == 1);
+    CHECK(fixture.manifestEntry().value("published").toString() == sha256(body));
+    CHECK(fixture.manager.isModelAvailable(MODEL));
+
+    // Later corruption is caught against the published digest, not waved
+    // through because the catalogue entry has no hash of its own
+    QByteArray corrupted = body;
+    corrupted[corrupted.size() / 2] = static_cast<char>(corrupted[corrupted.size() / 2] ^ 0x01);
+    writeFile(fixture.modelPath(), corrupted);
+    QFile file(fixture.modelPath());
+    CHECK(file.open(QIODevice::ReadWrite));
+    CHECK(file.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+    file.close();
+    CHECK(!fixture.manager.isModelAvailable(MODEL));
+}
+
+TEST_CASE(streaming_published_digest_mismatch) {
+    const QByteArray body = makeBody(2 * 1024 * 1024 + 5);
+    DownloadFixture fixture(body, 1);
+    fixture.server.setLinkedDigest(sha256("some other file"), body.size());
+
+    // The body arrives whole but is not what the host says it publishes
+    fixture.download();
+    CHECK(!fixture.success);
+    CHECK(!QFile::exists(fixture.modelPath()));
+    CHECK(!QFile::exists(fixture.partPath()));
+}
+
+TEST_CASE(segmented_pinned_hash_mismatch) {
+    const QByteArray body = makeBody(SEGMENTED_BYTES);
+    DownloadFixture fixture(body, SEGMENTS, true);
+    QByteArray served = body;
+    served[0] = static_cast<char>(served[0] ^ 0x01);
+    fixture.server.setBody(served);
+
+    fixture.download();
+    CHECK(!fixture.success);
+    CHECK(!QFile::exists(fixture.modelPath()));
+}
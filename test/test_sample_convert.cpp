@@ -0,0 +1,97 @@
+#include "test_support.hpp"
+#include "audio/sample_convert.hpp"
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+using whisper_client::audio::floatToInt16;
+using whisper_client::audio::int16ToFloat;
+using whisper_client::audio::sampleConversionKernel;
+
+namespace {
+
+// Longer than the widest kernel step, and not a multiple of 8 or 16, so
+// every call also runs the scalar tail
+constexpr size_t TAIL_COUNTS[] = {0, 1, 7, 9, 15, 17, 23, 37, 1003};
+
+// Rounded and clamped the way the header promises
+int16_t expectedInt16(float sample) {
+    const float scaled = std::nearbyint(sample * 32768.0f);
+    if (!(scaled > -32768.0f)) {
+        return -32768;
+    }
+    return scaled >= 32767.0f ? 32767 : static_cast<int16_t>(scaled);
+}
+
+} // namespace
+
+TEST_CASE(sample_convert_round_trip) {
+    std::printf("  kernel: %s\n", sampleConversionKernel());
+
+    // Every 16-bit value survives the trip to float and back
+    std::vector<int16_t> input;
+    for (int value = -32768; value <= 32767; ++value) {
+        input.push_back(static_cast<int16_t>(value));
+    }
+    std::vector<float> samples(input.size());
+    int16ToFloat(input.data(), samples.data(), input.size());
+
+    std::vector<int16_t> output(input.size());
+    floatToInt16(samples.data(), output.data(), samples.size());
+    CHECK(output == input);
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        CHECK(samples[i] == input[i] / 32768.0f);
+        CHECK(samples[i] >= -1.0f && samples[i] < 1.0f);
+    }
+}
+
+TEST_CASE(sample_convert_saturation) {
+    const float outOfRange[] = {1.0f, -1.0f, 1.5f, -1.5f, 1e6f, -1e6f, 1e30f, -1e30f,
+                                std::numeric_limits<float>::infinity(),
+                                -std::numeric_limits<float>::infinity()};
+
+    // Each value at every position of a block, so it lands in both the
+    // vector body and the scalar tail
+    for (float value : outOfRange) {
+        const int16_t expected = value > 0.0f ? 32767 : -32768;
+        for (size_t count : TAIL_COUNTS) {
+            for (size_t position = 0; position < count; ++position) {
+                std::vector<float> input(count, 0.25f);
+                input[position] = value;
+                std::vector<int16_t> output(count);
+                floatToInt16(input.data(), output.data(), count);
+                CHECK(output[position] == expected);
+                CHECK(output[(position + 1) % count] == (count == 1 ? expected : 8192));
+            }
+        }
+    }
+}
+
+TEST_CASE(sample_convert_tail_lengths) {
+    for (size_t count : TAIL_COUNTS) {
+        std::vector<float> input(count);
+        std::vector<int16_t> raw(count);
+        for (size_t i = 0; i < count; ++i) {
+            // Covers the range, halfway cases included, and overshoots it slightly
+            input[i] = static_cast<float>(std::sin(0.37 * i) * 1.1) + (i % 5 == 0 ? 0.5f / 32768.0f : 0.0f);
+            raw[i] = static_cast<int16_t>((i * 7919) & 0xffff);
+        }
+
+        // Guard elements past the end must not be written
+        std::vector<int16_t> converted(count + 1, 0x5a5a);
+        floatToInt16(input.data(), converted.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(converted[i] == expectedInt16(input[i]));
+        }
+        CHECK(converted[count] == 0x5a5a);
+
+        std::vector<float> widened(count + 1, 42.0f);
+        int16ToFloat(raw.data(), widened.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(widened[i] == raw[i] / 32768.0f);
+        }
+        CHECK(widened[count] == 42.0f);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace whisper_client {
+namespace test {
+
+// Minimal self-registering test cases. Each case is also registered with
+// CTest and run on its own as `whisper-client-tests <name>`.
+using TestFunction = void (*)();
+
+struct TestCase {
+    const char* name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& registry();
+
+struct Registrar {
+    Registrar(const char* name, TestFunction function) {
+        registry().push_back({name, function});
+    }
+};
+
+class Failure : public std::runtime_error {
+public:
+    Failure(const char* file, int line, const std::string& what)
+        : std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": " + what) {}
+};
+
+// Thrown by SKIP for a case that cannot run here, e.g. without a model file.
+// A run where every case skipped exits with SKIP_RETURN_CODE.
+class Skipped : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+constexpr int SKIP_RETURN_CODE = 77;
+
+// Spins the Qt event loop until condition holds or timeoutMs passes
+bool waitUntil(const std::function<bool()>& condition, int timeoutMs = 30000);
+
+} // namespace test
+} // namespace whisper_client
+
+#define TEST_CASE(name)                                                              \
+    static void name();                                                              \
+    static const ::whisper_client::test::Registrar name##_registrar(#name, &name);   \
+    static void name()
+
+#define SKIP(reason) throw ::whisper_client::test::Skipped(reason)
+
+#define CHECK(condition)                                                             \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            throw ::whisper_client::test::Failure(__FILE__, __LINE__, #condition);   \
+        }                                                                            \
+    } while (0)
@@ -0,0 +1,234 @@
+#include "test_support.hpp"
+#include "audio/voice_activity.hpp"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using whisper_client::audio::SpeechEndpointer;
+using whisper_client::audio::VoiceActivityDetector;
+
+namespace {
+
+constexpr size_t SAMPLE_RATE = 16000;
+constexpr double PI = 3.14159265358979323846;
+
+size_t samplesFor(double seconds) {
+    return static_cast<size_t>(seconds * SAMPLE_RATE);
+}
+
+double dbToAmplitude(double db) {
+    return std::pow(10.0, db / 20.0);
+}
+
+// Builds a clip piece by piece: white noise for the background, sines as a
+// stand-in for speech, which is all an energy detector can tell apart
+class Clip {
+public:
+    // Uniform noise with the given RMS level in dBFS
+    Clip& noise(double seconds, double db) {
+        return noiseRamp(seconds, db, db);
+    }
+
+    // Noise whose level moves linearly from one dBFS value to another
+    Clip& noiseRamp(double seconds, double fromDb, double toDb) {
+        const size_t count = samplesFor(seconds);
+        for (size_t i = 0; i < count; ++i) {
+            const double db = fromDb + (toDb - fromDb) * i / count;
+            // Uniform in [-0.5, 0.5) has an RMS of 1/sqrt(12)
+            samples.push_back(static_cast<float>(dbToAmplitude(db) * std::sqrt(12.0) * nextNoise()));
+        }
+        return *this;
+    }
+
+    // Sine at the given RMS level over a noise background
+    Clip& tone(double seconds, double db, double backgroundDb = -70.0) {
+        const size_t count = samplesFor(seconds);
+        const double amplitude = dbToAmplitude(db) * std::sqrt(2.0);
+        for (size_t i = 0; i < count; ++i) {
+            const double t = double(phase++) / SAMPLE_RATE;
+            samples.push_back(static_cast<float>(amplitude * std::sin(2.0 * PI * 220.0 * t) +
+                                                 dbToAmplitude(backgroundDb) * std::sqrt(12.0) * nextNoise()));
+        }
+        return *this;
+    }
+
+    // A single 5 ms full-scale spike
+    Clip& click() {
+        for (size_t i = 0; i < SAMPLE_RATE / 200; ++i) {
+            samples.push_back(i % 2 ? 0.9f : -0.9f);
+        }
+        return *this;
+    }
+
+    size_t size() const { return samples.size(); }
+    const std::vector<float>& data() const { return samples; }
+
+private:
+    double nextNoise() {
+        state = state * 1664525u + 1013904223u;
+        return double(state >> 8) / double(1 << 24) - 0.5;
+    }
+
+    std::vector<float> samples;
+    unsigned int state = 2463534242u;
+    size_t phase = 0;
+};
+
+VoiceActivityDetector::SpeechRange analyse(const Clip& clip) {
+    VoiceActivityDetector detector;
+    // Fed in capture-sized blocks
+    for (size_t pos = 0; pos < clip.size(); pos += 480) {
+        detector.addSamples(clip.data().data() + pos, std::min<size_t>(480, clip.size() - pos));
+    }
+    return detector.analyse();
+}
+
+struct EndpointEvent {
+    SpeechEndpointer::Event event;
+    size_t sample;  // One past the sample that raised it
+};
+
+std::vector<EndpointEvent> endpoint(const Clip& clip, unsigned int timeoutMs = 700) {
+    SpeechEndpointer endpointer;
+    endpointer.setEndpointTimeoutMs(timeoutMs);
+    std::vector<EndpointEvent> events;
+    size_t pos = 0;
+    while (pos < clip.size()) {
+        SpeechEndpointer::Event event;
+        pos += endpointer.feed(clip.data().data() + pos, std::min<size_t>(480, clip.size() - pos), &event);
+        if (event != SpeechEndpointer::Event::None) {
+            events.push_back({event, pos});
+        }
+    }
+    return events;
+}
+
+size_t countEvents(const std::vector<EndpointEvent>& events, SpeechEndpointer::Event kind) {
+    size_t count = 0;
+    for (const auto& event : events) {
+        count += event.event == kind ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE(vad_silence) {
+    CHECK(!analyse(Clip().noise(2.0, -70.0)).speech);
+    CHECK(!analyse(Clip().noise(2.0, -200.0)).speech);
+
+    // Steady room noise below the gate is not speech either
+    CHECK(!analyse(Clip().noise(3.0, -50.0)).speech);
+}
+
+TEST_CASE(vad_click) {
+    // An accidental key tap: a click in silence is not worth a decode
+    Clip clip;
+    clip.noise(0.5, -70.0).click().noise(0.5, -70.0);
+    CHECK(!analyse(clip).speech);
+}
+
+TEST_CASE(vad_tone_bursts_with_gaps) {
+    Clip clip;
+    clip.noise(1.0, -65.0);
+    const size_t speechBegin = clip.size();
+    clip.tone(0.5, -25.0, -65.0).noise(0.2, -65.0).tone(0.7, -25.0, -65.0);
+    const size_t speechEnd = clip.size();
+    clip.noise(1.5, -65.0);
+
+    const VoiceActivityDetector::SpeechRange range = analyse(clip);
+    CHECK(range.speech);
+
+    // Both bursts kept, with some padding but not the whole silence
+    CHECK(range.begin <= speechBegin);
+    CHECK(range.begin + samplesFor(0.5) >= speechBegin);
+    CHECK(range.end >= speechEnd);
+    CHECK(range.end <= speechEnd + samplesFor(0.5));
+    CHECK(range.end < clip.size());
+}
+
+TEST_CASE(vad_steady_level_clip) {
+    // Speech from press to release without a pause: there is no quiet frame
+    // to take the floor from, and the whole clip must be kept
+    Clip clip;
+    clip.tone(2.0, -25.0);
+    const VoiceActivityDetector::SpeechRange range = analyse(clip);
+    CHECK(range.speech);
+    CHECK(range.begin == 0);
+    CHECK(range.end == clip.size());
+}
+
+TEST_CASE(endpointer_silence) {
+    CHECK(endpoint(Clip().noise(10.0, -70.0)).empty());
+    CHECK(endpoint(Clip().noise(10.0, -200.0)).empty());
+}
+
+TEST_CASE(endpointer_click) {
+    Clip clip;
+    clip.noise(2.0, -65.0).click().noise(2.0, -65.0).click().noise(2.0, -65.0);
+    CHECK(countEvents(endpoint(clip), SpeechEndpointer::Event::SpeechStart) == 0);
+}
+
+TEST_CASE(endpointer_tone_bursts_with_gaps) {
+    // Gaps shorter than the timeout belong to the same utterance; a longer
+    // one closes it
+    Clip clip;
+    clip.noise(2.0, -65.0);
+    for (int i = 0; i < 3; ++i) {
+        clip.tone(0.4, -25.0, -65.0).noise(0.25, -65.0);
+    }
+    clip.noise(1.5, -65.0);
+    clip.tone(0.6, -25.0, -65.0).noise(2.0, -65.0);
+
+    const std::vector<EndpointEvent> events = endpoint(clip);
+    CHECK(events.size() == 4);
+    CHECK(events[0].event == SpeechEndpointer::Event::SpeechStart);
+    CHECK(events[1].event == SpeechEndpointer::Event::SpeechEnd);
+    CHECK(events[2].event == SpeechEndpointer::Event::SpeechStart);
+    CHECK(events[3].event == SpeechEndpointer::Event::SpeechEnd);
+
+    // Onset within 100 ms of the first burst
+    CHECK(events[0].sample >= samplesFor(2.0));
+    CHECK(events[0].sample <= samplesFor(2.1));
+}
+
+TEST_CASE(endpointer_slow_noise_rise) {
+    // A fan spinning up: the floor follows it, so it never reads as speech
+    Clip clip;
+    clip.noise(2.0, -70.0).noiseRamp(20.0, -70.0, -40.0).noise(5.0, -40.0);
+    const std::vector<EndpointEvent> events = endpoint(clip);
+    CHECK(countEvents(events, SpeechEndpointer::Event::SpeechEnd) == 0);
+
+    // Speech over the new, louder background is still picked up
+    clip.tone(1.0, -15.0, -40.0).noise(2.0, -40.0);
+    CHECK(countEvents(endpoint(clip), SpeechEndpointer::Event::SpeechEnd) == 1);
+}
+
+TEST_CASE(endpointer_noise_step_discarded) {
+    // A sudden, lasting rise opens an utterance until the floor catches up,
+    // but it is never handed on for decoding
+    Clip clip;
+    clip.noise(3.0, -70.0).noise(15.0, -45.0);
+    const std::vector<EndpointEvent> events = endpoint(clip);
+    CHECK(countEvents(events, SpeechEndpointer::Event::SpeechEnd) == 0);
+    CHECK(countEvents(events, SpeechEndpointer::Event::SpeechDiscard) <= 1);
+}
+
+TEST_CASE(endpointer_timeout) {
+    for (unsigned int timeoutMs : {300u, 700u, 1500u}) {
+        Clip clip;
+        clip.noise(2.0, -65.0).tone(1.0, -25.0, -65.0);
+        const size_t speechEnd = clip.size();
+        clip.noise(3.0, -65.0);
+
+        const std::vector<EndpointEvent> events = endpoint(clip, timeoutMs);
+        CHECK(events.size() == 2);
+        CHECK(events[1].event == SpeechEndpointer::Event::SpeechEnd);
+
+        // Ends one timeout after the last voiced frame, to within a frame or two
+        const double delayMs = (double(events[1].sample) - double(speechEnd)) * 1000.0 / SAMPLE_RATE;
+        std::printf("  timeout %u ms: end reported after %.0f ms\n", timeoutMs, delayMs);
+        CHECK(delayMs >= timeoutMs - 40.0);
+        CHECK(delayMs <= timeoutMs + 40.0);
+    }
+}